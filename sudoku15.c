@@ -3,15 +3,37 @@
 #include <math.h>
 #include <time.h>
 #include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "sudoku_solver.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
-#define MAX_N 16
+#define MAX_N 36        // największa obsługiwana plansza (dowolny kwadrat liczby całkowitej)
 
-// Parametry algorytmu genetycznego
+// Domyślne parametry algorytmu genetycznego (zmieniane opcjami lub plikiem --config)
 #define POPULATION_SIZE 1000
 #define NUM_GENERATIONS 10000
 #define MUTATION_RATE 0.15
 #define CROSSOVER_RATE 0.8
 #define ELITISM_RATE 0.2
+#define TOURNAMENT_SIZE 3
+
+// Pomiary czasu faz pokolenia: -DGA_PROFILE=1 przy kompilacji.
+// Domyślnie wyłączone - makra pomiarowe nie generują wtedy żadnego kodu.
+#ifndef GA_PROFILE
+#define GA_PROFILE 0
+#endif
 
 int N;
 int SRN;
@@ -19,12 +41,195 @@ int **board;
 int **fixed;
 int **solution;
 
+// Typ komórki osobnika - jeden bajt wystarcza dla N <= MAX_N
+typedef unsigned char cell_t;
+
+// Zbiór wartości jako maska bitowa - bit v-1 oznacza wartość v (do 64 wartości)
+typedef uint64_t mask_t;
+
 // Struktura osobnika (rozwiązania Sudoku)
 typedef struct {
-    int **grid;
+    cell_t *grid;   // n*n komórek zapisanych wierszami
+    cell_t *counts; // liczności wartości: n wierszy, n kolumn i n bloków po n+1 pozycji
+                    // (w potomstwie GA aktualne tylko po recountIndividual)
     int fitness;
+    uint64_t hash;  // skrót Zobrista planszy, aktualizowany razem z fitness
 } Individual;
 
+// Populacja trzymana w jednym ciągłym bloku pamięci (arenie)
+typedef struct {
+    Individual *members;    // size + 1 osobników, ostatni to bufor roboczy
+    cell_t *cells;          // (size + 1) * n * n komórek
+    cell_t *counts;         // (size + 1) * COUNTS_SIZE(n) liczników
+    int size;
+} Population;
+
+// Rozmiar tablic liczności jednego osobnika i dostęp do nich
+#define COUNTS_SIZE(n) (3 * (n) * ((n) + 1))
+#define ROW_COUNT(ind, n, r) ((ind)->counts + (r) * ((n) + 1))
+#define COL_COUNT(ind, n, c) ((ind)->counts + ((n) + (c)) * ((n) + 1))
+#define BLOCK_COUNT(ind, n, b) ((ind)->counts + (2 * (n) + (b)) * ((n) + 1))
+
+// Łamigłówka widziana przez solver: rozmiar, wskazówki i komórki stałe.
+// Każde rozwiązywanie pracuje na własnej instancji, więc wiele łamigłówek
+// może być rozwiązywanych jednocześnie w jednym procesie.
+typedef struct SolverKernels SolverKernels;
+
+typedef struct {
+    int n, srn;
+    cell_t *givens;         // n*n wartości startowych, 0 = pusta komórka
+    unsigned char *fixed;   // n*n, 1 = komórka stała
+    int *units;             // 3n jednostek po n indeksów komórek: wiersze, kolumny, bloki
+    int *rowOf, *colOf;     // wiersz i kolumna każdej komórki
+    int *blockOf;           // numer bloku każdej komórki
+    int *fixedCells;        // indeksy komórek stałych
+    int fixedCount;
+    int *freeCells;         // indeksy wszystkich niezamrożonych komórek
+    int freeCount;
+    int *blockStart;        // blockFree[blockStart[b] .. blockStart[b + 1]) to wolne komórki bloku b
+    int *blockFree;
+    uint64_t *zobrist;      // losowe klucze skrótu: n*n komórek po n+1 wartości
+    int givenBlockConflicts;    // duplikaty wśród wskazówek w blokach (stałe, 0 dla poprawnej łamigłówki)
+    int blockOperators;     // operatory zachowujące bloki - fitness tylko z wierszy i kolumn
+    const SolverKernels *kernels;   // jądra wybrane dla rozmiaru n
+} Puzzle;
+
+// Klucz Zobrista wartości val w komórce cell
+#define ZOBRIST(pz, n, cell, val) ((pz)->zobrist[(cell) * ((n) + 1) + (val)])
+
+// Generator liczb losowych z własnym stanem - każdy wątek ma osobny strumień
+typedef struct {
+    uint64_t s[4];
+} Rng;
+
+static inline uint64_t rotl64(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// xoshiro256**: mały stan, bardzo szybki, dobrej jakości
+static inline uint64_t rngNext(Rng *rng) {
+    uint64_t *s = rng->s;
+    uint64_t result = rotl64(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl64(s[3], 45);
+    return result;
+}
+
+// Liczba całkowita z zakresu [0, n) bez obciążenia modulo (metoda Lemire'a)
+static inline int rngInt(Rng *rng, int n) {
+    uint64_t m = (rngNext(rng) >> 32) * (uint64_t)n;
+    uint32_t low = (uint32_t)m;
+    if (low < (uint32_t)n) {
+        uint32_t threshold = -(uint32_t)n % (uint32_t)n;
+        while (low < threshold) {
+            m = (rngNext(rng) >> 32) * (uint64_t)n;
+            low = (uint32_t)m;
+        }
+    }
+    return (int)(m >> 32);
+}
+
+// Liczba rzeczywista z zakresu [0, 1)
+static inline double rngDouble(Rng *rng) {
+    return (rngNext(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Liczba porażek przed pierwszym sukcesem w próbach o prawdopodobieństwie p,
+// gdzie logKeep = log(1 - p). Pozwala przeskoczyć od razu do następnej
+// mutowanej komórki zamiast losować osobno dla każdej.
+static inline int rngGeometric(Rng *rng, double logKeep) {
+    if (logKeep == 0) return INT32_MAX;
+    double skip = log(1.0 - rngDouble(rng)) / logKeep;
+    return skip < INT32_MAX ? (int)skip : INT32_MAX;
+}
+
+// Niezależny strumień dla danego ziarna i numeru strumienia (stan z splitmix64)
+void rngSeed(Rng *rng, uint64_t seed, uint64_t stream) {
+    uint64_t x = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+    for (int i = 0; i < 4; i++) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        rng->s[i] = z ^ (z >> 31);
+    }
+}
+
+// Ustawienia uruchomienia (z linii poleceń)
+int gaThreads = 1;          // liczba wątków produkujących potomstwo
+uint64_t gaSeed = 0;        // ziarno (--seed); bez niego brane z zegara
+int gaSeedSet = 0;          // czy ziarno podano jawnie (--seed)
+int gaBlockOperators = 1;   // tylko operatory zachowujące permutacje w blokach (--operators blocks|mixed)
+int gaPopulationSize = POPULATION_SIZE;     // --population
+int gaGenerations = NUM_GENERATIONS;        // --generations
+double gaMutationRate = MUTATION_RATE;      // --mutation
+double gaCrossoverRate = CROSSOVER_RATE;    // --crossover-rate
+double gaElitismRate = ELITISM_RATE;        // --elitism
+int gaTournamentSize = TOURNAMENT_SIZE;     // --tournament
+int gaCrossover = SOLVER_CROSSOVER_MIXED;   // --crossover mixed|point|block
+
+// Nazwy operatorów krzyżowania (--crossover, pliki konfiguracji) w kolejności SOLVER_CROSSOVER_*
+const char *crossoverNames[] = { "mixed", "point", "block" };
+Rng gameRng;                // strumień do generowania plansz i ruchów poza GA
+
+// Czas monotoniczny w sekundach
+double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// ===== Pomiary faz i liczniki =====
+
+enum {
+    PHASE_ELITE,                // wybór elity (sortowanie przez zliczanie)
+    PHASE_PREPARE,              // przygotowanie selekcji (tablica aliasów)
+    PHASE_SELECT,               // losowanie rodziców
+    PHASE_CROSSOVER,            // krzyżowanie lub kopiowanie rodziców
+    PHASE_EVALUATE,             // przeliczenie konfliktów dzieci
+    PHASE_MUTATE,               // mutacja z przyrostową oceną
+    PHASE_LOCAL,                // lokalne przeszukiwanie dzieci (tryb memetyczny)
+    PHASE_COUNT
+};
+
+static const char *phaseNames[PHASE_COUNT] = {
+    "elite", "prepare", "select", "crossover", "evaluate", "mutate", "local"
+};
+
+typedef struct {
+    uint64_t nanos[PHASE_COUNT];
+    uint64_t calls[PHASE_COUNT];
+} PhaseTimes;
+
+long gaAllocations = 0;         // alokacje struktur GA (liczone przy GA_PROFILE)
+
+#if GA_PROFILE
+static inline uint64_t profileNow() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+#define PROFILE_START(t) uint64_t t = profileNow()
+#define PROFILE_STOP(times, phase, t) \
+    ((times)->nanos[phase] += profileNow() - (t), (times)->calls[phase]++)
+#define PROFILE_ALLOC(count) __atomic_fetch_add(&gaAllocations, (count), __ATOMIC_RELAXED)
+#else
+#define PROFILE_START(t) ((void)0)
+#define PROFILE_STOP(times, phase, t) ((void)0)
+#define PROFILE_ALLOC(count) ((void)0)
+#endif
+
+static inline void addPhaseTimes(PhaseTimes *dest, const PhaseTimes *src) {
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        dest->nanos[p] += src->nanos[p];
+        dest->calls[p] += src->calls[p];
+    }
+}
+
 // Alokacja pamięci
 void allocBoard() {
     board = malloc(N * sizeof(int *));
@@ -49,23 +254,29 @@ void freeBoard() {
     free(solution);
 }
 
-// Alokacja pamięci dla osobnika
-Individual* createIndividual() {
-    Individual *ind = malloc(sizeof(Individual));
-    ind->grid = malloc(N * sizeof(int *));
-    for (int i = 0; i < N; i++) {
-        ind->grid[i] = malloc(N * sizeof(int));
+// Alokacja areny populacji - jedna alokacja na wszystkie plansze
+void allocPopulation(Population *pop, int size, const Puzzle *pz) {
+    int n = pz->n;
+    pop->size = size;
+    pop->members = malloc((size + 1) * sizeof(Individual));
+    pop->cells = malloc((size_t)(size + 1) * n * n * sizeof(cell_t));
+    pop->counts = malloc((size_t)(size + 1) * COUNTS_SIZE(n) * sizeof(cell_t));
+    PROFILE_ALLOC(3);
+    for (int i = 0; i <= size; i++) {
+        pop->members[i].grid = pop->cells + (size_t)i * n * n;
+        pop->members[i].counts = pop->counts + (size_t)i * COUNTS_SIZE(n);
+        pop->members[i].fitness = 0;
     }
-    return ind;
 }
 
-// Zwolnienie pamięci osobnika
-void freeIndividual(Individual *ind) {
-    for (int i = 0; i < N; i++) {
-        free(ind->grid[i]);
-    }
-    free(ind->grid);
-    free(ind);
+// Zwolnienie areny populacji
+void freePopulation(Population *pop) {
+    free(pop->members);
+    free(pop->cells);
+    free(pop->counts);
+    pop->members = NULL;
+    pop->cells = NULL;
+    pop->counts = NULL;
 }
 
 // Kopiowanie planszy
@@ -75,610 +286,4618 @@ void copyGrid(int **source, int **dest) {
     }
 }
 
-// Sprawdza czy dane są poprawne według zasad sudoku
-int isSafe(int row, int col, int num, int **grid) {
-    for (int x = 0; x < N; x++)
-        if (grid[row][x] == num || grid[x][col] == num)
-            return 0;
+// Kopiowanie osobnika (plansza, skrót i fitness); liczności nie są kopiowane -
+// w populacji GA są nieaktualne, a każdy ich użytkownik liczy je od nowa
+void copyIndividual(const Puzzle *pz, const Individual *source, Individual *dest) {
+    int n = pz->n;
+    memcpy(dest->grid, source->grid, n * n * sizeof(cell_t));
+    dest->fitness = source->fitness;
+    dest->hash = source->hash;
+}
 
-    int startRow = row - row % SRN, startCol = col - col % SRN;
-    for (int i = 0; i < SRN; i++)
-        for (int j = 0; j < SRN; j++)
-            if (grid[i + startRow][j + startCol] == num)
-                return 0;
+// Przepisanie planszy int** do zwartej postaci osobnika
+void loadCells(int **source, cell_t *dest) {
+    for (int i = 0; i < N; i++)
+        for (int j = 0; j < N; j++)
+            dest[i * N + j] = source[i][j];
+}
 
-    return 1;
+// Przepisanie zwartej planszy osobnika do int**
+void storeCells(const cell_t *source, int **dest) {
+    for (int i = 0; i < N; i++)
+        for (int j = 0; j < N; j++)
+            dest[i][j] = source[i * N + j];
 }
 
-// Wypełnia planszę sudoku
-int fillBoard(int row, int col, int **grid) {
-    if (row == N - 1 && col == N)
-        return 1;
-    if (col == N) {
-        row++;
-        col = 0;
+// Przeszukiwanie z nawrotami na jawnym stosie. Zajęte wartości wierszy, kolumn i bloków
+// są maskami bitowymi, a jako następna wybierana jest komórka z najmniejszą liczbą
+// kandydatów (MRV). Z rng kandydaci i remisy losowane są (generator), bez rng kolejność
+// jest stała (licznik rozwiązań). Zwraca liczbę znalezionych rozwiązań, najwyżej limit,
+// lub -1 po przekroczeniu backtrackLimit nawrotów. Pierwsze rozwiązanie zostaje w cells;
+// gdy go nie ma, cells wraca do stanu wejściowego.
+int searchSolutions(int n, cell_t *cells, Rng *rng, int limit, long backtrackLimit) {
+    int srn = (int)sqrt(n), count = n * n;
+    mask_t full = (((mask_t)1 << n) - 1);
+    mask_t rowUsed[MAX_N] = {0}, colUsed[MAX_N] = {0}, boxUsed[MAX_N] = {0};
+    int placed[MAX_N * MAX_N];              // stos: komórki w kolejności wypełniania
+    mask_t untried[MAX_N * MAX_N];          // nie wypróbowani kandydaci każdego poziomu
+    cell_t first[MAX_N * MAX_N];            // pierwsze znalezione rozwiązanie
+    int depth = 0, empty = 0, found = 0;
+    
+    for (int cell = 0; cell < count; cell++) {
+        int val = cells[cell];
+        if (val == 0) {
+            empty++;
+            continue;
+        }
+        int r = cell / n, c = cell % n, b = (r / srn) * srn + c / srn;
+        mask_t bit = ((mask_t)1 << (val - 1));
+        if ((rowUsed[r] | colUsed[c] | boxUsed[b]) & bit) return 0;
+        rowUsed[r] |= bit;
+        colUsed[c] |= bit;
+        boxUsed[b] |= bit;
     }
+    
+    long backtracks = 0;
+    int descend = 1;
+    while (1) {
+        if (depth == empty) {
+            // Kompletne rozwiązanie - zapamiętaj pierwsze i szukaj dalej do limitu
+            if (found++ == 0) memcpy(first, cells, count * sizeof(cell_t));
+            if (found >= limit || depth == 0) break;
+            depth--;
+            descend = 0;
+        }
+        
+        if (descend) {
+            // Najbardziej ograniczona pusta komórka
+            int best = -1, bestCount = n + 1, ties = 0;
+            mask_t bestCand = 0;
+            for (int cell = 0; cell < count; cell++) {
+                if (cells[cell]) continue;
+                int r = cell / n, c = cell % n;
+                mask_t cand = full & ~(rowUsed[r] | colUsed[c] | boxUsed[(r / srn) * srn + c / srn]);
+                int size = __builtin_popcountll(cand);
+                if (size < bestCount) {
+                    best = cell; bestCount = size; bestCand = cand; ties = 1;
+                    if (size <= 1) break;
+                } else if (rng && size == bestCount && rngInt(rng, ++ties) == 0) {
+                    best = cell; bestCand = cand;
+                }
+            }
+            placed[depth] = best;
+            untried[depth] = bestCand;
+        } else {
+            // Nawrót: cofnij wartość wpisaną na tym poziomie
+            int cell = placed[depth], r = cell / n, c = cell % n;
+            mask_t bit = ((mask_t)1 << (cells[cell] - 1));
+            rowUsed[r] &= ~bit;
+            colUsed[c] &= ~bit;
+            boxUsed[(r / srn) * srn + c / srn] &= ~bit;
+            cells[cell] = 0;
+        }
+        
+        mask_t cand = untried[depth];
+        if (cand == 0) {
+            // Brak kandydatów - wróć poziom wyżej
+            if (depth == 0) break;
+            if (++backtracks > backtrackLimit) {
+                found = -1;
+                break;
+            }
+            depth--;
+            descend = 0;
+            continue;
+        }
+        
+        // Kolejny kandydat: losowy albo najmniejszy
+        if (rng) {
+            for (int skip = rngInt(rng, __builtin_popcountll(cand)); skip > 0; skip--) {
+                cand &= cand - 1;
+            }
+        }
+        mask_t bit = cand & -cand;
+        untried[depth] &= ~bit;
+        int cell = placed[depth], r = cell / n, c = cell % n;
+        cells[cell] = __builtin_ctzll(bit) + 1;
+        rowUsed[r] |= bit;
+        colUsed[c] |= bit;
+        boxUsed[(r / srn) * srn + c / srn] |= bit;
+        depth++;
+        descend = 1;
+    }
+    
+    // Przywróć wejście, a następnie wpisz pierwsze rozwiązanie (jeśli jest)
+    for (int k = 0; k < depth; k++) cells[placed[k]] = 0;
+    if (found > 0) memcpy(cells, first, count * sizeof(cell_t));
+    return found;
+}
 
-    if (grid[row][col] != 0)
-        return fillBoard(row, col + 1, grid);
-
-    int nums[N];
-    for (int i = 0; i < N; i++)
-        nums[i] = i + 1;
+// Liczy rozwiązania łamigłówki, przerywając po limit; -1 po przekroczeniu budżetu nawrotów
+int countSolutions(int n, const cell_t *cells, int limit, long backtrackLimit) {
+    cell_t work[MAX_N * MAX_N];
+    memcpy(work, cells, n * n * sizeof(cell_t));
+    return searchSolutions(n, work, NULL, limit, backtrackLimit);
+}
 
-    for (int i = N - 1; i > 0; i--) {
-        int j = rand() % (i + 1);
-        int temp = nums[i];
-        nums[i] = nums[j];
-        nums[j] = temp;
+// Losuje permutację 0..count-1
+static void shuffledOrder(int *order, int count, Rng *rng) {
+    for (int k = 0; k < count; k++) order[k] = k;
+    for (int k = count - 1; k > 0; k--) {
+        int swap = rngInt(rng, k + 1);
+        int tmp = order[k];
+        order[k] = order[swap];
+        order[swap] = tmp;
     }
+}
 
-    for (int i = 0; i < N; i++) {
-        int num = nums[i];
-        if (isSafe(row, col, num, grid)) {
-            grid[row][col] = num;
-            if (fillBoard(row, col + 1, grid))
-                return 1;
-            grid[row][col] = 0;
+// Pełna plansza z planszy wzorcowej przez przekształcenia zachowujące poprawność:
+// permutację wartości, wierszy w pasach, pasów, kolumn w stosach i stosów. Działa w O(n*n)
+// i zawsze się udaje, w przeciwieństwie do przeszukiwania, które dla pustych plansz
+// większych niż 16x16 potrafi nie znaleźć rozwiązania w rozsądnym czasie.
+void shuffledPatternGrid(int n, cell_t *cells, Rng *rng) {
+    int srn = (int)sqrt(n);
+    int values[MAX_N], bands[MAX_N], stacks[MAX_N], rows[MAX_N], cols[MAX_N], inner[MAX_N];
+    shuffledOrder(values, n, rng);
+    shuffledOrder(bands, srn, rng);
+    shuffledOrder(stacks, srn, rng);
+    for (int band = 0; band < srn; band++) {
+        shuffledOrder(inner, srn, rng);
+        for (int k = 0; k < srn; k++) rows[band * srn + k] = bands[band] * srn + inner[k];
+    }
+    for (int stack = 0; stack < srn; stack++) {
+        shuffledOrder(inner, srn, rng);
+        for (int k = 0; k < srn; k++) cols[stack * srn + k] = stacks[stack] * srn + inner[k];
+    }
+    for (int r = 0; r < n; r++) {
+        for (int c = 0; c < n; c++) {
+            int pr = rows[r], pc = cols[c];
+            cells[r * n + c] = values[(pr * srn + pr / srn + pc) % n] + 1;
         }
     }
+}
 
+// Wypełnia planszę losowym poprawnym rozwiązaniem; niezerowe pola zostają bez zmian.
+// Po 4*n*n nawrotach wyszukiwanie startuje od nowa z innymi losowaniami, co ucina
+// długie ogony czasu dla 16x16. Puste plansze większe niż 16x16 powstają z planszy
+// wzorcowej. Zwraca 0, gdy się nie udało.
+int fillGrid(int n, cell_t *cells, Rng *rng) {
+    if (n > 16) {
+        int empty = 1;
+        for (int k = 0; k < n * n && empty; k++) empty = cells[k] == 0;
+        if (empty) {
+            shuffledPatternGrid(n, cells, rng);
+            return 1;
+        }
+    }
+    for (int restart = 0; restart < 100; restart++) {
+        int found = searchSolutions(n, cells, rng, 1, 4L * n * n);
+        if (found >= 0) return found;
+    }
     return 0;
 }
 
-// Liczy konflikty (duplikaty) w wierszach i kolumnach
-int calculate_conflicts(int **grid) {
-    int conflicts = 0;
+int fillBoard(int **grid) {
+    cell_t cells[MAX_N * MAX_N];
+    loadCells(grid, cells);
+    int ok = fillGrid(N, cells, &gameRng);
+    storeCells(cells, grid);
+    return ok;
+}
+
+// Budżet jednego sprawdzenia jednoznaczności w nawrotach razy komórki planszy (każdy krok
+// przeszukiwania skanuje planszę), więc czas sprawdzenia nie rośnie z rozmiarem planszy
+#define UNIQUENESS_WORK (20000L * 256)
+
+static inline long uniquenessBudget(int n) {
+    return UNIQUENESS_WORK / (n * n);
+}
+
+// Czy wartość usuniętej komórki wynika wprost z pozostałych wskazówek: jedyny kandydat
+// komórki albo jedyne miejsce dla tej wartości w wierszu, kolumnie lub bloku
+static int forcedAfterRemoval(int n, const cell_t *cells, int cell, mask_t bit,
+                              const mask_t *rowUsed, const mask_t *colUsed, const mask_t *boxUsed) {
+    int srn = (int)sqrt(n), r = cell / n, c = cell % n, b = (r / srn) * srn + c / srn;
+    mask_t full = (((mask_t)1 << n) - 1);
+    if ((full & ~(rowUsed[r] | colUsed[c] | boxUsed[b])) == bit) return 1;
     
-    // Konflikty w wierszach
-for (int i = 0; i < N; i++) {
-    int count[N+1];
-    for (int k = 0; k <= N; k++) count[k] = 0;
-        for (int j = 0; j < N; j++) {
-            count[grid[i][j]]++;
+    for (int unit = 0; unit < 3; unit++) {
+        int elsewhere = 0;
+        for (int k = 0; k < n && !elsewhere; k++) {
+            int other = unit == 0 ? r * n + k : unit == 1 ? k * n + c
+                      : ((b / srn) * srn + k / srn) * n + (b % srn) * srn + k % srn;
+            if (other == cell || cells[other]) continue;
+            int orow = other / n, ocol = other % n, obox = (orow / srn) * srn + ocol / srn;
+            elsewhere = !((rowUsed[orow] | colUsed[ocol] | boxUsed[obox]) & bit);
         }
-        for (int k = 1; k <= N; k++) {
-            if (count[k] > 1) conflicts += count[k] - 1;
+        if (!elsewhere) return 1;
+    }
+    return 0;
+}
+
+// Usuwa wartości z pełnej planszy w losowej kolejności, zostawiając tylko te usunięcia,
+// po których łamigłówka ma nadal dokładnie jedno rozwiązanie. Komórki wymuszone przez
+// pozostałe wskazówki usuwane są bez przeszukiwania. Kończy na clues wskazówkach lub gdy
+// żadnej komórki nie da się już usunąć; zwraca liczbę pozostałych wskazówek.
+int carvePuzzle(int n, cell_t *cells, int clues, Rng *rng) {
+    int srn = (int)sqrt(n);
+    int order[MAX_N * MAX_N];
+    int remaining = n * n;
+    mask_t rowUsed[MAX_N] = {0}, colUsed[MAX_N] = {0}, boxUsed[MAX_N] = {0};
+    shuffledOrder(order, n * n, rng);
+    for (int k = 0; k < n * n; k++) {
+        if (!cells[k]) {
+            remaining--;
+            continue;
         }
+        int r = k / n, c = k % n;
+        mask_t bit = (mask_t)1 << (cells[k] - 1);
+        rowUsed[r] |= bit;
+        colUsed[c] |= bit;
+        boxUsed[(r / srn) * srn + c / srn] |= bit;
     }
     
-    // Konflikty w kolumnach
-for (int j = 0; j < N; j++) {
-    int count[N+1];
-    for (int k = 0; k <= N; k++) count[k] = 0;
-        for (int i = 0; i < N; i++) {
-            count[grid[i][j]]++;
+    for (int k = 0; k < n * n && remaining > clues; k++) {
+        int cell = order[k];
+        int val = cells[cell];
+        if (!val) continue;
+        int r = cell / n, c = cell % n, b = (r / srn) * srn + c / srn;
+        mask_t bit = (mask_t)1 << (val - 1);
+        cells[cell] = 0;
+        rowUsed[r] &= ~bit;
+        colUsed[c] &= ~bit;
+        boxUsed[b] &= ~bit;
+        if (forcedAfterRemoval(n, cells, cell, bit, rowUsed, colUsed, boxUsed) ||
+            countSolutions(n, cells, 2, uniquenessBudget(n)) == 1) {
+            remaining--;
+        } else {
+            // Niejednoznaczne lub za drogie do sprawdzenia
+            cells[cell] = val;
+            rowUsed[r] |= bit;
+            colUsed[c] |= bit;
+            boxUsed[b] |= bit;
         }
-        for (int k = 1; k <= N; k++) {
-            if (count[k] > 1) conflicts += count[k] - 1;
+    }
+    return remaining;
+}
+
+// ===== Wsadowy silnik oceny (maski bitowe, SIMD) =====
+//
+// Zawartość jednostki (wiersza, kolumny, bloku) to maska zajętości wartości:
+// liczba różnych wartości = popcount(maska), a konflikty = niezerowe - popcount.
+// Partia osobników ułożona jest kolumnowo (SoA): komórka k osobnika b leży pod
+// cells[k * stride + b], dzięki czemu jeden wektor obejmuje wielu osobników naraz.
+// Algorytm genetyczny pakuje tu potomstwo każdego wątku po mutacji i ocenia je jednym
+// wywołaniem jądra wybranego przez selectEvalKernel.
+
+#define EVAL_LANES 32   // stride partii jest wielokrotnością szerokości AVX2
+
+typedef struct {
+    cell_t *cells;  // n * n * stride komórek
+    int *fitness;   // wynik dla każdego osobnika
+    int count;      // liczba osobników w partii
+    int stride;     // count zaokrąglone w górę do EVAL_LANES
+    int units;      // oceniane jednostki od początku pz->units: 3n albo 2n (bez bloków)
+    int baseFitness;    // stałe konflikty dodawane do wyniku (duplikaty wskazówek w blokach)
+} EvalBatch;
+
+typedef void (*EvalKernel)(const Puzzle *pz, EvalBatch *batch);
+
+void allocEvalBatch(const Puzzle *pz, EvalBatch *batch, int count) {
+    int n = pz->n;
+    batch->count = count;
+    batch->stride = (count + EVAL_LANES - 1) / EVAL_LANES * EVAL_LANES;
+    batch->units = 3 * n;
+    batch->baseFitness = 0;
+    batch->cells = calloc((size_t)n * n * batch->stride, sizeof(cell_t));
+    batch->fitness = malloc(batch->stride * sizeof(int));
+}
+
+void freeEvalBatch(EvalBatch *batch) {
+    free(batch->cells);
+    free(batch->fitness);
+    batch->cells = NULL;
+    batch->fitness = NULL;
+}
+
+// Przepisanie planszy osobnika (AoS) na pozycję b partii (SoA)
+static inline void packIndividual(const Puzzle *pz, const Individual *ind, EvalBatch *batch, int b) {
+    cell_t *dest = batch->cells + b;
+    for (int k = 0; k < pz->n * pz->n; k++)
+        dest[(size_t)k * batch->stride] = ind->grid[k];
+}
+
+void packPopulation(const Puzzle *pz, const Population *pop, EvalBatch *batch) {
+    for (int b = 0; b < batch->count; b++) packIndividual(pz, &pop->members[b], batch, b);
+}
+
+// Przenośna wersja skalarna
+void evalBatchScalar(const Puzzle *pz, EvalBatch *batch) {
+    int n = pz->n;
+    for (int b = 0; b < batch->count; b++) {
+        int conflicts = batch->baseFitness;
+        for (int u = 0; u < batch->units; u++) {
+            mask_t mask = 0;
+            int filled = 0;
+            for (int k = 0; k < n; k++) {
+                int val = batch->cells[(size_t)pz->units[u * n + k] * batch->stride + b];
+                mask |= ((mask_t)1 << val) >> 1;
+                filled += val != 0;
+            }
+            conflicts += filled - __builtin_popcountll(mask);
         }
+        batch->fitness[b] = conflicts;
     }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// Maska 16-bitowa trzymana jako dwie płaszczyzny bajtów: wartości 1-8 i 9-16.
+// pshufb z indeksem val-1 zamienia wartość na bit; 0 daje indeks 0xFF, czyli zero.
+__attribute__((target("ssse3")))
+void evalBatchSSSE3(const Puzzle *pz, EvalBatch *batch) {
+    int n = pz->n;
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i lowBits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i highBits = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128);
+    const __m128i popTable = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
     
-    // Konflikty w blokach 3x3
-for (int block_row = 0; block_row < SRN; block_row++) {
-    for (int block_col = 0; block_col < SRN; block_col++) {
-        int count[N+1];
-        for (int k = 0; k <= N; k++) count[k] = 0;
-            for (int i = 0; i < SRN; i++) {
-                for (int j = 0; j < SRN; j++) {
-                    int val = grid[block_row*SRN + i][block_col*SRN + j];
-                    count[val]++;
-                }
-            }
-            for (int k = 1; k <= N; k++) {
-                if (count[k] > 1) conflicts += count[k] - 1;
+    for (int b = 0; b < batch->count; b += 16) {
+        __m128i accLow = zero, accHigh = zero;
+        for (int u = 0; u < batch->units; u++) {
+            __m128i low = zero, high = zero, filled = zero;
+            for (int k = 0; k < n; k++) {
+                const cell_t *src = batch->cells + (size_t)pz->units[u * n + k] * batch->stride + b;
+                __m128i val = _mm_loadu_si128((const __m128i *)src);
+                __m128i index = _mm_sub_epi8(val, one);
+                low = _mm_or_si128(low, _mm_shuffle_epi8(lowBits, index));
+                high = _mm_or_si128(high, _mm_shuffle_epi8(highBits, index));
+                filled = _mm_sub_epi8(filled, _mm_andnot_si128(_mm_cmpeq_epi8(val, zero), _mm_set1_epi8(-1)));
             }
+            __m128i distinct = _mm_add_epi8(
+                _mm_add_epi8(_mm_shuffle_epi8(popTable, _mm_and_si128(low, nibble)),
+                             _mm_shuffle_epi8(popTable, _mm_and_si128(_mm_srli_epi16(low, 4), nibble))),
+                _mm_add_epi8(_mm_shuffle_epi8(popTable, _mm_and_si128(high, nibble)),
+                             _mm_shuffle_epi8(popTable, _mm_and_si128(_mm_srli_epi16(high, 4), nibble))));
+            __m128i conflicts = _mm_sub_epi8(filled, distinct);
+            accLow = _mm_add_epi16(accLow, _mm_unpacklo_epi8(conflicts, zero));
+            accHigh = _mm_add_epi16(accHigh, _mm_unpackhi_epi8(conflicts, zero));
         }
+        uint16_t out[16];
+        _mm_storeu_si128((__m128i *)out, accLow);
+        _mm_storeu_si128((__m128i *)(out + 8), accHigh);
+        for (int i = 0; i < 16 && b + i < batch->count; i++)
+            batch->fitness[b + i] = batch->baseFitness + out[i];
     }
-    
-    return conflicts;
 }
 
-// Inicjalizuje populację
-void initializePopulation(Individual **population) {
-    for (int i = 0; i < POPULATION_SIZE; i++) {
-        population[i] = createIndividual();
-        copyGrid(board, population[i]->grid);
-        
-        // Wypełnij puste komórki losowymi wartościami, ale zgodnymi z blokami 3x3
-        for (int block_row = 0; block_row < SRN; block_row++) {
-            for (int block_col = 0; block_col < SRN; block_col++) {
-                int used[N+1];
-                for (int u = 0; u <= N; u++) used[u] = 0;
-                
-                // Zaznacz już używane liczby w bloku
-                for (int r = 0; r < SRN; r++) {
-                    for (int c = 0; c < SRN; c++) {
-                        int val = population[i]->grid[block_row*SRN + r][block_col*SRN + c];
-                        if (val != 0) used[val] = 1;
-                    }
-                }
-                
-                // Wypełnij puste komórki unikalnymi wartościami w bloku
-                for (int r = 0; r < SRN; r++) {
-                    for (int c = 0; c < SRN; c++) {
-                        if (population[i]->grid[block_row*SRN + r][block_col*SRN + c] == 0 && 
-                            !fixed[block_row*SRN + r][block_col*SRN + c]) {
-                            
-                            int val;
-                            do {
-                                val = (rand() % N) + 1;
-                            } while (used[val]);
-                            
-                            population[i]->grid[block_row*SRN + r][block_col*SRN + c] = val;
-                            used[val] = 1;
-                        }
-                    }
-                }
+// To samo co SSSE3, ale 32 osobniki na wektor
+__attribute__((target("avx2")))
+void evalBatchAVX2(const Puzzle *pz, EvalBatch *batch) {
+    int n = pz->n;
+    const __m256i one = _mm256_set1_epi8(1);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i lowBits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0,
+                                             1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i highBits = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128,
+                                              0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128);
+    const __m256i popTable = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                              0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    
+    for (int b = 0; b < batch->count; b += 32) {
+        __m256i accLow = zero, accHigh = zero;
+        for (int u = 0; u < batch->units; u++) {
+            __m256i low = zero, high = zero, filled = zero;
+            for (int k = 0; k < n; k++) {
+                const cell_t *src = batch->cells + (size_t)pz->units[u * n + k] * batch->stride + b;
+                __m256i val = _mm256_loadu_si256((const __m256i *)src);
+                __m256i index = _mm256_sub_epi8(val, one);
+                low = _mm256_or_si256(low, _mm256_shuffle_epi8(lowBits, index));
+                high = _mm256_or_si256(high, _mm256_shuffle_epi8(highBits, index));
+                filled = _mm256_sub_epi8(filled, _mm256_andnot_si256(_mm256_cmpeq_epi8(val, zero), _mm256_set1_epi8(-1)));
             }
+            __m256i distinct = _mm256_add_epi8(
+                _mm256_add_epi8(_mm256_shuffle_epi8(popTable, _mm256_and_si256(low, nibble)),
+                                _mm256_shuffle_epi8(popTable, _mm256_and_si256(_mm256_srli_epi16(low, 4), nibble))),
+                _mm256_add_epi8(_mm256_shuffle_epi8(popTable, _mm256_and_si256(high, nibble)),
+                                _mm256_shuffle_epi8(popTable, _mm256_and_si256(_mm256_srli_epi16(high, 4), nibble))));
+            __m256i conflicts = _mm256_sub_epi8(filled, distinct);
+            accLow = _mm256_add_epi16(accLow, _mm256_cvtepu8_epi16(_mm256_castsi256_si128(conflicts)));
+            accHigh = _mm256_add_epi16(accHigh, _mm256_cvtepu8_epi16(_mm256_extracti128_si256(conflicts, 1)));
         }
-        
-        population[i]->fitness = calculate_conflicts(population[i]->grid);
+        uint16_t out[32];
+        _mm256_storeu_si256((__m256i *)out, accLow);
+        _mm256_storeu_si256((__m256i *)(out + 16), accHigh);
+        for (int i = 0; i < 32 && b + i < batch->count; i++)
+            batch->fitness[b + i] = batch->baseFitness + out[i];
     }
 }
 
-// Selekcja turniejowa
-Individual* tournamentSelection(Individual **population, int tournamentSize) {
-    Individual *best = population[rand() % POPULATION_SIZE];
-    for (int i = 1; i < tournamentSize; i++) {
-        Individual *contender = population[rand() % POPULATION_SIZE];
-        if (contender->fitness < best->fitness) {
-            best = contender;
+#endif
+
+// Wybór najszybszego jądra dostępnego na tym procesorze (wektory tylko dla n <= 16)
+EvalKernel selectEvalKernel(const Puzzle *pz, const char **name) {
+    int n = pz->n;
+#if defined(__x86_64__) || defined(__i386__)
+    if (n <= 16) {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            if (name) *name = "avx2";
+            return evalBatchAVX2;
+        }
+        if (__builtin_cpu_supports("ssse3")) {
+            if (name) *name = "ssse3";
+            return evalBatchSSSE3;
         }
     }
-    return best;
+#endif
+    if (name) *name = "scalar";
+    return evalBatchScalar;
+}
+
+// ===== Jądra solvera specjalizowane rozmiarem planszy =====
+//
+// Ciała gorących funkcji przyjmują n i srn jako parametry i są zawsze wstawiane
+// w miejscu wywołania. Warianty dla 4x4 i 16x16 dostają stałe, więc kompilator
+// może rozwinąć pętle i zastąpić dzielenia; wariant ogólny czyta rozmiar z łamigłówki.
+// Dla 9x9 stałe nie dawały mierzalnego zysku (--bench-kernels), więc działa wariant ogólny.
+// Wybór wariantu następuje raz, w puzzleInit.
+
+#define KERNEL static inline __attribute__((always_inline))
+
+// Liczy konflikty (duplikaty) w wierszach, kolumnach i blokach
+KERNEL int conflictsBody(const Puzzle *pz, const cell_t *grid, const int n, const int srn) {
+    int conflicts = 0;
+    (void)srn;
+    for (int u = 0; u < 3 * n; u++) {
+        int count[MAX_N + 1] = { 0 };
+        const int *cells = pz->units + u * n;
+        for (int k = 0; k < n; k++) {
+            count[grid[cells[k]]]++;
+        }
+        for (int k = 1; k <= n; k++) {
+            if (count[k] > 1) conflicts += count[k] - 1;
+        }
+    }
+    return conflicts;
 }
 
-// Selekcja ruletkowa (proporcjonalna do fitness)
-Individual* rouletteWheelSelection(Individual **population) {
-    // Oblicz całkowity fitness (odwrotność konfliktów)
-    double totalFitness = 0;
-    for (int i = 0; i < POPULATION_SIZE; i++) {
-        totalFitness += 1.0 / (population[i]->fitness + 1);
+// Przelicza od zera tablice liczności osobnika i jego fitness.
+// Potomstwo GA ich nie utrzymuje (ocena partiami), więc liczy się je przed lokalnym
+// przeszukiwaniem; dalej zamiany aktualizują je przyrostowo.
+// Bez scoreBlocks bloki nie są liczone: operatory blokowe utrzymują w nich permutacje,
+// więc jedyne konflikty blokowe to stałe duplikaty wśród wskazówek.
+KERNEL void recountBody(const Puzzle *pz, Individual *ind, const int n, const int srn, const int scoreBlocks) {
+    (void)srn;
+    memset(ind->counts, 0, (scoreBlocks ? 3 : 2) * n * (n + 1) * sizeof(cell_t));
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            int val = ind->grid[i * n + j];
+            ROW_COUNT(ind, n, i)[val]++;
+            COL_COUNT(ind, n, j)[val]++;
+            if (scoreBlocks) BLOCK_COUNT(ind, n, pz->blockOf[i * n + j])[val]++;
+        }
     }
     
-    // Losuj wartość z zakresu 0-totalFitness
-    double slice = ((double)rand() / RAND_MAX) * totalFitness;
-    
-    // Znajdź osobnika odpowiadającego wylosowanej wartości
-    double currentSum = 0;
-    for (int i = 0; i < POPULATION_SIZE; i++) {
-        currentSum += 1.0 / (population[i]->fitness + 1);
-        if (currentSum >= slice) {
-            return population[i];
+    int conflicts = scoreBlocks ? 0 : pz->givenBlockConflicts;
+    for (int unit = 0; unit < (scoreBlocks ? 3 : 2) * n; unit++) {
+        const cell_t *count = ind->counts + unit * (n + 1);
+        for (int k = 1; k <= n; k++) {
+            if (count[k] > 1) conflicts += count[k] - 1;
         }
     }
+    ind->fitness = conflicts;
+}
+
+// Usunięcie wartości z jednostki - zwraca zmianę liczby konfliktów
+static inline int removeValue(cell_t *count, int val) {
+    return count[val]-- > 1 ? -1 : 0;
+}
+
+// Dodanie wartości do jednostki - zwraca zmianę liczby konfliktów
+static inline int addValue(cell_t *count, int val) {
+    return count[val]++ > 0 ? 1 : 0;
+}
+
+// Zamiana dwóch komórek z aktualizacją fitness w O(1) - dotyka tylko
+// wierszy, kolumn i bloków, które faktycznie się zmieniają
+KERNEL void swapCellsBody(const Puzzle *pz, Individual *ind, int first, int second, const int n) {
+    int a = ind->grid[first];
+    int b = ind->grid[second];
+    if (a == b) return;
+    
+    int delta = 0;
+    int r1 = pz->rowOf[first], r2 = pz->rowOf[second];
+    if (r1 != r2) {
+        delta += removeValue(ROW_COUNT(ind, n, r1), a) + removeValue(ROW_COUNT(ind, n, r2), b);
+        delta += addValue(ROW_COUNT(ind, n, r1), b) + addValue(ROW_COUNT(ind, n, r2), a);
+    }
+    int c1 = pz->colOf[first], c2 = pz->colOf[second];
+    if (c1 != c2) {
+        delta += removeValue(COL_COUNT(ind, n, c1), a) + removeValue(COL_COUNT(ind, n, c2), b);
+        delta += addValue(COL_COUNT(ind, n, c1), b) + addValue(COL_COUNT(ind, n, c2), a);
+    }
+    int b1 = pz->blockOf[first], b2 = pz->blockOf[second];
+    if (b1 != b2) {
+        delta += removeValue(BLOCK_COUNT(ind, n, b1), a) + removeValue(BLOCK_COUNT(ind, n, b2), b);
+        delta += addValue(BLOCK_COUNT(ind, n, b1), b) + addValue(BLOCK_COUNT(ind, n, b2), a);
+    }
     
-    return population[POPULATION_SIZE - 1];
+    ind->grid[first] = b;
+    ind->grid[second] = a;
+    ind->fitness += delta;
+    ind->hash ^= ZOBRIST(pz, n, first, a) ^ ZOBRIST(pz, n, first, b)
+               ^ ZOBRIST(pz, n, second, b) ^ ZOBRIST(pz, n, second, a);
 }
 
-// Krzyżowanie jednopunktowe (dla wierszy)
-void singlePointCrossover(Individual *parent1, Individual *parent2, Individual *child1, Individual *child2) {
-    int crossoverPoint = rand() % N;
+// Zmiana wartości komórki z aktualizacją fitness w O(1)
+KERNEL void setCellBody(const Puzzle *pz, Individual *ind, int cell, int val, const int n) {
+    int old = ind->grid[cell];
+    if (old == val) return;
     
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
-            if (i < crossoverPoint) {
-                child1->grid[i][j] = parent1->grid[i][j];
-                child2->grid[i][j] = parent2->grid[i][j];
-            } else {
-                child1->grid[i][j] = parent2->grid[i][j];
-                child2->grid[i][j] = parent1->grid[i][j];
-            }
-        }
+    int r = pz->rowOf[cell], c = pz->colOf[cell], b = pz->blockOf[cell];
+    int delta = removeValue(ROW_COUNT(ind, n, r), old) + addValue(ROW_COUNT(ind, n, r), val);
+    delta += removeValue(COL_COUNT(ind, n, c), old) + addValue(COL_COUNT(ind, n, c), val);
+    delta += removeValue(BLOCK_COUNT(ind, n, b), old) + addValue(BLOCK_COUNT(ind, n, b), val);
+    
+    ind->grid[cell] = val;
+    ind->fitness += delta;
+    ind->hash ^= ZOBRIST(pz, n, cell, old) ^ ZOBRIST(pz, n, cell, val);
+}
+
+// Zamiana dwóch komórek bez liczności i fitness - tylko plansza i skrót
+// (potomstwo GA oceniane jest po mutacji partiami)
+KERNEL void swapGenesBody(const Puzzle *pz, Individual *ind, int first, int second, const int n) {
+    int a = ind->grid[first];
+    int b = ind->grid[second];
+    ind->grid[first] = b;
+    ind->grid[second] = a;
+    ind->hash ^= ZOBRIST(pz, n, first, a) ^ ZOBRIST(pz, n, first, b)
+               ^ ZOBRIST(pz, n, second, b) ^ ZOBRIST(pz, n, second, a);
+}
+
+// Zmiana wartości komórki bez liczności i fitness
+KERNEL void setGeneBody(const Puzzle *pz, Individual *ind, int cell, int val, const int n) {
+    int old = ind->grid[cell];
+    ind->grid[cell] = val;
+    ind->hash ^= ZOBRIST(pz, n, cell, old) ^ ZOBRIST(pz, n, cell, val);
+}
+
+// Przywraca wartości stałych komórek w obu dzieciach
+KERNEL void restoreFixed(const Puzzle *pz, Individual *child1, Individual *child2) {
+    for (int k = 0; k < pz->fixedCount; k++) {
+        int cell = pz->fixedCells[k];
+        child1->grid[cell] = pz->givens[cell];
+        child2->grid[cell] = pz->givens[cell];
+    }
+}
+
+// Wymiana końcówek plansz od komórki split (wiersze są ciągłe w pamięci)
+KERNEL void splitCrossoverBody(const Puzzle *pz, Individual *parent1, Individual *parent2,
+                               Individual *child1, Individual *child2, int split, const int n) {
+    // Skróty dzieci to skróty rodziców z podmienionym fragmentem - wystarczy przejść krótszy
+    uint64_t diff = 0;
+    int prefix = split <= n * n - split;
+    int from = prefix ? 0 : split, to = prefix ? split : n * n;
+    for (int cell = from; cell < to; cell++) {
+        diff ^= ZOBRIST(pz, n, cell, parent1->grid[cell]) ^ ZOBRIST(pz, n, cell, parent2->grid[cell]);
     }
+    child1->hash = (prefix ? parent2->hash : parent1->hash) ^ diff;
+    child2->hash = (prefix ? parent1->hash : parent2->hash) ^ diff;
+    
+    // Wystarczą dwa kopiowania na dziecko
+    memcpy(child1->grid, parent1->grid, split * sizeof(cell_t));
+    memcpy(child1->grid + split, parent2->grid + split, (n * n - split) * sizeof(cell_t));
+    memcpy(child2->grid, parent2->grid, split * sizeof(cell_t));
+    memcpy(child2->grid + split, parent1->grid + split, (n * n - split) * sizeof(cell_t));
     
     // Upewnij się, że stałe wartości pozostają niezmienione
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
-            if (fixed[i][j]) {
-                child1->grid[i][j] = board[i][j];
-                child2->grid[i][j] = board[i][j];
-            }
-        }
-    }
+    restoreFixed(pz, child1, child2);
+}
+
+// Krzyżowanie jednopunktowe (dla wierszy)
+KERNEL void singlePointBody(const Puzzle *pz, Individual *parent1, Individual *parent2,
+                            Individual *child1, Individual *child2, Rng *rng, const int n) {
+    int crossoverPoint = rngInt(rng, n);
+    splitCrossoverBody(pz, parent1, parent2, child1, child2, crossoverPoint * n, n);
+}
+
+// Krzyżowanie pasmowe - cięcie tylko na granicy pasm bloków, więc bloki dzieci
+// pochodzą w całości od jednego rodzica i pozostają permutacjami
+KERNEL void bandCrossoverBody(const Puzzle *pz, Individual *parent1, Individual *parent2,
+                              Individual *child1, Individual *child2, Rng *rng, const int n, const int srn) {
+    int crossoverBand = rngInt(rng, srn);
+    splitCrossoverBody(pz, parent1, parent2, child1, child2, crossoverBand * srn * n, n);
 }
 
 // Krzyżowanie blokowe (dla bloków Sudoku)
-void blockCrossover(Individual *parent1, Individual *parent2, Individual *child1, Individual *child2) {
-    int blockRow = rand() % SRN;
-    int blockCol = rand() % SRN;
+KERNEL void blockCrossoverBody(const Puzzle *pz, Individual *parent1, Individual *parent2,
+                               Individual *child1, Individual *child2, Rng *rng, const int n, const int srn) {
+    int blockRow = rngInt(rng, srn);
+    int blockCol = rngInt(rng, srn);
     
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
-            int currentBlockRow = i / SRN;
-            int currentBlockCol = j / SRN;
-            
-            if (currentBlockRow == blockRow && currentBlockCol == blockCol) {
-                child1->grid[i][j] = parent2->grid[i][j];
-                child2->grid[i][j] = parent1->grid[i][j];
-            } else {
-                child1->grid[i][j] = parent1->grid[i][j];
-                child2->grid[i][j] = parent2->grid[i][j];
-            }
+    memcpy(child1->grid, parent1->grid, n * n * sizeof(cell_t));
+    memcpy(child2->grid, parent2->grid, n * n * sizeof(cell_t));
+    
+    // Zamień zawartość wylosowanego bloku (wiersz bloku to srn ciągłych komórek)
+    uint64_t diff = 0;
+    for (int i = blockRow * srn; i < (blockRow + 1) * srn; i++) {
+        int start = i * n + blockCol * srn;
+        memcpy(child1->grid + start, parent2->grid + start, srn * sizeof(cell_t));
+        memcpy(child2->grid + start, parent1->grid + start, srn * sizeof(cell_t));
+        for (int cell = start; cell < start + srn; cell++) {
+            diff ^= ZOBRIST(pz, n, cell, parent1->grid[cell]) ^ ZOBRIST(pz, n, cell, parent2->grid[cell]);
         }
     }
+    child1->hash = parent1->hash ^ diff;
+    child2->hash = parent2->hash ^ diff;
     
     // Upewnij się, że stałe wartości pozostają niezmienione
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
-            if (fixed[i][j]) {
-                child1->grid[i][j] = board[i][j];
-                child2->grid[i][j] = board[i][j];
-            }
-        }
-    }
+    restoreFixed(pz, child1, child2);
 }
 
-// Mutacja - zamiana dwóch komórek w bloku
-void swapMutation(Individual *ind) {
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
-            if (!fixed[i][j] && ((double)rand() / RAND_MAX) < MUTATION_RATE) {
-                // Znajdź inny losowy niezamrożony element w tym samym bloku
-                int blockRow = i / SRN;
-                int blockCol = j / SRN;
-                int attempts = 0;
-                
-                do {
-                    int r = blockRow * SRN + (rand() % SRN);
-                    int c = blockCol * SRN + (rand() % SRN);
-                    attempts++;
-                    
-                    if (!fixed[r][c] && attempts < 10) {
-                        // Zamień wartości
-                        int temp = ind->grid[i][j];
-                        ind->grid[i][j] = ind->grid[r][c];
-                        ind->grid[r][c] = temp;
-                        break;
-                    }
-                } while (attempts < 10);
-            }
-        }
+// Mutacja - zamiana dwóch komórek w bloku.
+// Każda wolna komórka mutuje z prawdopodobieństwem p (logKeep = log(1 - p)); kolejne mutowane
+// komórki wyznacza losowanie geometryczne, a partnera wybiera się z wolnych komórek bloku.
+KERNEL void swapMutationBody(const Puzzle *pz, Individual *ind, Rng *rng, double logKeep, const int n) {
+    for (int k = rngGeometric(rng, logKeep); k < pz->freeCount; k += 1 + rngGeometric(rng, logKeep)) {
+        int cell = pz->freeCells[k];
+        int block = pz->blockOf[cell];
+        int first = pz->blockStart[block];
+        int other = pz->blockFree[first + rngInt(rng, pz->blockStart[block + 1] - first)];
+        
+        // Zamień wartości (fitness liczony później, przy ocenie partii)
+        swapGenesBody(pz, ind, cell, other, n);
     }
 }
 
 // Mutacja - losowa zmiana wartości komórki
-void randomResetMutation(Individual *ind) {
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
-            if (!fixed[i][j] && ((double)rand() / RAND_MAX) < MUTATION_RATE) {
-                ind->grid[i][j] = (rand() % N) + 1;
-            }
-        }
+KERNEL void randomResetBody(const Puzzle *pz, Individual *ind, Rng *rng, double logKeep, const int n) {
+    for (int k = rngGeometric(rng, logKeep); k < pz->freeCount; k += 1 + rngGeometric(rng, logKeep)) {
+        int cell = pz->freeCells[k];
+        setGeneBody(pz, ind, cell, rngInt(rng, n) + 1, n);
     }
 }
 
-// Znajdź najlepszego osobnika w populacji
-Individual* findBestIndividual(Individual **population) {
-    Individual *best = population[0];
-    for (int i = 1; i < POPULATION_SIZE; i++) {
-        if (population[i]->fitness < best->fitness) {
-            best = population[i];
-        }
+// Zmiana konfliktów w wierszach i kolumnach po zamianie dwóch komórek jednego bloku,
+// bez wykonywania zamiany (bloki się nie zmieniają)
+KERNEL int swapDeltaBody(const Puzzle *pz, const Individual *ind, int first, int second, const int n) {
+    int a = ind->grid[first], b = ind->grid[second];
+    int delta = 0;
+    int r1 = pz->rowOf[first], r2 = pz->rowOf[second];
+    if (r1 != r2) {
+        const cell_t *row1 = ROW_COUNT(ind, n, r1), *row2 = ROW_COUNT(ind, n, r2);
+        delta += (row1[b] > 0) + (row2[a] > 0) - (row1[a] > 1) - (row2[b] > 1);
     }
-    return best;
+    int c1 = pz->colOf[first], c2 = pz->colOf[second];
+    if (c1 != c2) {
+        const cell_t *col1 = COL_COUNT(ind, n, c1), *col2 = COL_COUNT(ind, n, c2);
+        delta += (col1[b] > 0) + (col2[a] > 0) - (col1[a] > 1) - (col2[b] > 1);
+    }
+    return delta;
 }
 
-// Algorytm genetyczny do rozwiązania Sudoku
-void solveSudokuGA() {
-    srand(time(NULL));
-    
-    // Inicjalizacja populacji
-    Individual *population[POPULATION_SIZE];
-    Individual *newPopulation[POPULATION_SIZE];
-    initializePopulation(population);
-    
-    Individual *bestIndividual = findBestIndividual(population);
-    printf("Początkowa liczba konfliktów: %d\n", bestIndividual->fitness);
-    
-    for (int generation = 0; generation < NUM_GENERATIONS; generation++) {
-        // Elitaryzm - zachowaj najlepsze osobniki
-        int eliteCount = POPULATION_SIZE * ELITISM_RATE;
-        
-        // Posortuj populację według fitness
-        for (int i = 0; i < POPULATION_SIZE - 1; i++) {
-            for (int j = i + 1; j < POPULATION_SIZE; j++) {
-                if (population[j]->fitness < population[i]->fitness) {
-                    Individual *temp = population[i];
-                    population[i] = population[j];
-                    population[j] = temp;
-                }
+// Lokalne przeszukiwanie min-conflicts: w każdym z budget kroków losowa wolna komórka
+// w konflikcie wiersza lub kolumny zamieniana jest z tą komórką swojego bloku, która
+// najbardziej zmniejsza liczbę konfliktów (remisy losowo). Krok bez poprawy nic nie zmienia.
+// Zwraca liczbę wykonanych zamian
+KERNEL int localSearchBody(const Puzzle *pz, Individual *ind, Rng *rng, int budget, const int n) {
+    int moves = 0;
+    for (int step = 0; step < budget && ind->fitness > 0; step++) {
+        // Pierwsza komórka w konflikcie od losowego miejsca listy wolnych komórek
+        int cell = -1;
+        int start = rngInt(rng, pz->freeCount);
+        for (int k = 0; k < pz->freeCount; k++) {
+            int index = start + k < pz->freeCount ? start + k : start + k - pz->freeCount;
+            int candidate = pz->freeCells[index];
+            int val = ind->grid[candidate];
+            if (ROW_COUNT(ind, n, pz->rowOf[candidate])[val] > 1 || COL_COUNT(ind, n, pz->colOf[candidate])[val] > 1) {
+                cell = candidate;
+                break;
             }
         }
+        if (cell < 0) break;
         
-        // Przenieś najlepsze osobniki do nowej populacji
-        for (int i = 0; i < eliteCount; i++) {
-            newPopulation[i] = createIndividual();
-            copyGrid(population[i]->grid, newPopulation[i]->grid);
-            newPopulation[i]->fitness = population[i]->fitness;
-        }
-        
-        // Wypełnij resztę nowej populacji poprzez selekcję, krzyżowanie i mutację
-        for (int i = eliteCount; i < POPULATION_SIZE; i += 2) {
-            // Selekcja rodziców (można wybrać różne metody)
-            Individual *parent1 = tournamentSelection(population, 3);
-            Individual *parent2 = rouletteWheelSelection(population);
-            
-            // Stwórz dzieci
-            Individual *child1 = createIndividual();
-            Individual *child2 = createIndividual();
-            
-            // Krzyżowanie (można wybrać różne metody)
-            if ((double)rand() / RAND_MAX < CROSSOVER_RATE) {
-                if (rand() % 2 == 0) {
-                    singlePointCrossover(parent1, parent2, child1, child2);
-                } else {
-                    blockCrossover(parent1, parent2, child1, child2);
-                }
-            } else {
-                copyGrid(parent1->grid, child1->grid);
-                copyGrid(parent2->grid, child2->grid);
-            }
-            
-            // Mutacja (można wybrać różne metody)
-            if (rand() % 2 == 0) {
-                swapMutation(child1);
-                swapMutation(child2);
-            } else {
-                randomResetMutation(child1);
-                randomResetMutation(child2);
+        int block = pz->blockOf[cell];
+        int bestDelta = 0, bestOther = -1, ties = 0;
+        for (int k = pz->blockStart[block]; k < pz->blockStart[block + 1]; k++) {
+            int other = pz->blockFree[k];
+            if (other == cell) continue;
+            int delta = swapDeltaBody(pz, ind, cell, other, n);
+            if (delta < bestDelta) {
+                bestDelta = delta;
+                bestOther = other;
+                ties = 1;
+            } else if (delta == bestDelta && bestOther >= 0 && rngInt(rng, ++ties) == 0) {
+                bestOther = other;
             }
-            
-            // Oblicz fitness dzieci
-            child1->fitness = calculate_conflicts(child1->grid);
-            child2->fitness = calculate_conflicts(child2->grid);
-            
-            // Dodaj dzieci do nowej populacji
-            newPopulation[i] = child1;
-            if (i + 1 < POPULATION_SIZE) {
-                newPopulation[i + 1] = child2;
-            }
-        }
-        
-        // Zastąp starą populację nową
-        for (int i = 0; i < POPULATION_SIZE; i++) {
-            freeIndividual(population[i]);
-            population[i] = newPopulation[i];
-        }
-        
-        // Znajdź najlepszego osobnika w nowej populacji
-        bestIndividual = findBestIndividual(population);
-        
-        // Wyświetl postęp
-        if (generation % 100 == 0) {
-            printf("Pokolenie %d: Najlepszy fitness = %d\n", generation, bestIndividual->fitness);
         }
-        
-        // Zakończ jeśli znaleziono rozwiązanie
-        if (bestIndividual->fitness == 0) {
-            printf("Znaleziono rozwiązanie w pokoleniu %d\n", generation);
-            break;
+        if (bestOther >= 0) {
+            swapCellsBody(pz, ind, cell, bestOther, n);
+            moves++;
         }
     }
-    
-    // Skopiuj najlepsze rozwiązanie do planszy
-    copyGrid(bestIndividual->grid, board);
-    
-    // Wyświetl wynik
-    printf("\nSudoku rozwiązane przez GA (konflikty: %d)\n", bestIndividual->fitness);
-    
-    // Zwolnij pamięć
-    for (int i = 0; i < POPULATION_SIZE; i++) {
-        freeIndividual(population[i]);
-    }
+    return moves;
 }
 
-// Usuwa komórki z planszy, aby stworzyć zagadkę sudoku z określoną liczbą wskazówek
-void removeCells(int clues) {
-    for (int i = 0; i < N; i++)
-        for (int j = 0; j < N; j++)
-            fixed[i][j] = 1;
+// Zestaw jąder dla jednego rozmiaru planszy
+struct SolverKernels {
+    const char *name;
+    int (*conflicts)(const Puzzle *pz, const cell_t *grid);
+    void (*recount)(const Puzzle *pz, Individual *ind);
+    void (*recountLines)(const Puzzle *pz, Individual *ind);
+    void (*singlePoint)(const Puzzle *pz, Individual *p1, Individual *p2, Individual *c1, Individual *c2, Rng *rng);
+    void (*blockCrossover)(const Puzzle *pz, Individual *p1, Individual *p2, Individual *c1, Individual *c2, Rng *rng);
+    void (*bandCrossover)(const Puzzle *pz, Individual *p1, Individual *p2, Individual *c1, Individual *c2, Rng *rng);
+    void (*swapMutation)(const Puzzle *pz, Individual *ind, Rng *rng, double logKeep);
+    void (*randomReset)(const Puzzle *pz, Individual *ind, Rng *rng, double logKeep);
+    int (*localSearch)(const Puzzle *pz, Individual *ind, Rng *rng, int budget);
+    int (*swapDelta)(const Puzzle *pz, const Individual *ind, int first, int second);
+};
 
-    int cellsToRemove = N * N - clues;
-    while (cellsToRemove > 0) {
-        int i = rand() % N;
-        int j = rand() % N;
-        if (board[i][j] != 0) {
-            board[i][j] = 0;
-            fixed[i][j] = 0;
-            cellsToRemove--;
-        }
+#define DEFINE_SOLVER_KERNELS(SUFFIX, NN, SS) \
+    static int conflicts##SUFFIX(const Puzzle *pz, const cell_t *grid) { \
+        return conflictsBody(pz, grid, NN, SS); \
+    } \
+    static void recount##SUFFIX(const Puzzle *pz, Individual *ind) { \
+        recountBody(pz, ind, NN, SS, 1); \
+    } \
+    static void recountLines##SUFFIX(const Puzzle *pz, Individual *ind) { \
+        recountBody(pz, ind, NN, SS, 0); \
+    } \
+    static void singlePoint##SUFFIX(const Puzzle *pz, Individual *p1, Individual *p2, Individual *c1, Individual *c2, Rng *rng) { \
+        singlePointBody(pz, p1, p2, c1, c2, rng, NN); \
+    } \
+    static void blockCrossover##SUFFIX(const Puzzle *pz, Individual *p1, Individual *p2, Individual *c1, Individual *c2, Rng *rng) { \
+        blockCrossoverBody(pz, p1, p2, c1, c2, rng, NN, SS); \
+    } \
+    static void bandCrossover##SUFFIX(const Puzzle *pz, Individual *p1, Individual *p2, Individual *c1, Individual *c2, Rng *rng) { \
+        bandCrossoverBody(pz, p1, p2, c1, c2, rng, NN, SS); \
+    } \
+    static void swapMutation##SUFFIX(const Puzzle *pz, Individual *ind, Rng *rng, double logKeep) { \
+        swapMutationBody(pz, ind, rng, logKeep, NN); \
+    } \
+    static void randomReset##SUFFIX(const Puzzle *pz, Individual *ind, Rng *rng, double logKeep) { \
+        randomResetBody(pz, ind, rng, logKeep, NN); \
+    } \
+    static int localSearch##SUFFIX(const Puzzle *pz, Individual *ind, Rng *rng, int budget) { \
+        return localSearchBody(pz, ind, rng, budget, NN); \
+    } \
+    static int swapDelta##SUFFIX(const Puzzle *pz, const Individual *ind, int first, int second) { \
+        return swapDeltaBody(pz, ind, first, second, NN); \
+    } \
+    static const SolverKernels kernels##SUFFIX = { \
+        #SUFFIX, conflicts##SUFFIX, recount##SUFFIX, recountLines##SUFFIX, singlePoint##SUFFIX, \
+        blockCrossover##SUFFIX, bandCrossover##SUFFIX, swapMutation##SUFFIX, randomReset##SUFFIX, \
+        localSearch##SUFFIX, swapDelta##SUFFIX \
+    };
+
+DEFINE_SOLVER_KERNELS(4, 4, 2)
+DEFINE_SOLVER_KERNELS(16, 16, 4)
+DEFINE_SOLVER_KERNELS(Generic, pz->n, pz->srn)
+
+// Jądra dla danego rozmiaru; dla rozmiarów bez specjalizacji wariant ogólny
+const SolverKernels *selectSolverKernels(int n) {
+    switch (n) {
+        case 4: return &kernels4;
+        case 16: return &kernels16;
+        default: return &kernelsGeneric;
     }
 }
 
-// Wyświetla aktualny stan planszy
+// Publiczne punkty wejścia - przekazują wywołanie do jąder wybranych dla łamigłówki
+int calculate_conflicts(const Puzzle *pz, const cell_t *grid) {
+    return pz->kernels->conflicts(pz, grid);
+}
+
+// Przy operatorach blokowych fitness liczy tylko wiersze i kolumny
+void recountIndividual(const Puzzle *pz, Individual *ind) {
+    if (pz->blockOperators) pz->kernels->recountLines(pz, ind);
+    else pz->kernels->recount(pz, ind);
+}
+
+// Skrót planszy liczony od zera; dalej utrzymywany przyrostowo przez zamiany i mutacje
+uint64_t genomeHash(const Puzzle *pz, const cell_t *grid) {
+    uint64_t hash = 0;
+    for (int cell = 0; cell < pz->n * pz->n; cell++) {
+        hash ^= ZOBRIST(pz, pz->n, cell, grid[cell]);
+    }
+    return hash;
+}
+
+void swapCells(const Puzzle *pz, Individual *ind, int first, int second) {
+    swapCellsBody(pz, ind, first, second, pz->n);
+}
+
+void setCell(const Puzzle *pz, Individual *ind, int cell, int val) {
+    setCellBody(pz, ind, cell, val, pz->n);
+}
+
+void swapGenes(const Puzzle *pz, Individual *ind, int first, int second) {
+    swapGenesBody(pz, ind, first, second, pz->n);
+}
+
+void singlePointCrossover(const Puzzle *pz, Individual *parent1, Individual *parent2, Individual *child1, Individual *child2, Rng *rng) {
+    pz->kernels->singlePoint(pz, parent1, parent2, child1, child2, rng);
+}
+
+void blockCrossover(const Puzzle *pz, Individual *parent1, Individual *parent2, Individual *child1, Individual *child2, Rng *rng) {
+    pz->kernels->blockCrossover(pz, parent1, parent2, child1, child2, rng);
+}
+
+void bandCrossover(const Puzzle *pz, Individual *parent1, Individual *parent2, Individual *child1, Individual *child2, Rng *rng) {
+    pz->kernels->bandCrossover(pz, parent1, parent2, child1, child2, rng);
+}
+
+void swapMutation(const Puzzle *pz, Individual *ind, Rng *rng, double logKeep) {
+    pz->kernels->swapMutation(pz, ind, rng, logKeep);
+}
+
+void randomResetMutation(const Puzzle *pz, Individual *ind, Rng *rng, double logKeep) {
+    pz->kernels->randomReset(pz, ind, rng, logKeep);
+}
+
+int localSearch(const Puzzle *pz, Individual *ind, Rng *rng, int budget) {
+    return pz->kernels->localSearch(pz, ind, rng, budget);
+}
+
+int swapDelta(const Puzzle *pz, const Individual *ind, int first, int second) {
+    return pz->kernels->swapDelta(pz, ind, first, second);
+}
+
+// Wczytuje do przygotowanej łamigłówki nowe wskazówki i komórki stałe tego samego rozmiaru
+// i odbudowuje listy wolnych komórek - bez alokacji, więc serwer może używać jednej
+// łamigłówki dla kolejnych zadań
+void puzzleLoad(Puzzle *pz, const cell_t *givens, const unsigned char *fixed) {
+    int n = pz->n;
+    memcpy(pz->givens, givens, n * n * sizeof(cell_t));
+    memcpy(pz->fixed, fixed, n * n);
+    
+    pz->freeCount = 0;
+    pz->fixedCount = 0;
+    for (int cell = 0; cell < n * n; cell++) {
+        if (pz->fixed[cell]) pz->fixedCells[pz->fixedCount++] = cell;
+        else pz->freeCells[pz->freeCount++] = cell;
+    }
+    
+    int position = 0;
+    for (int b = 0; b < n; b++) {
+        pz->blockStart[b] = position;
+        for (int k = 0; k < n; k++) {
+            int cell = pz->units[(2 * n + b) * n + k];
+            if (!pz->fixed[cell]) pz->blockFree[position++] = cell;
+        }
+    }
+    pz->blockStart[n] = position;
+    
+    // Powtórzone wskazówki w blokach - stała część fitness przy operatorach blokowych
+    pz->givenBlockConflicts = 0;
+    for (int b = 0; b < n; b++) {
+        int seen[MAX_N + 1] = { 0 };
+        for (int k = 0; k < n; k++) {
+            int cell = pz->units[(2 * n + b) * n + k];
+            if (pz->fixed[cell] && seen[pz->givens[cell]]++) pz->givenBlockConflicts++;
+        }
+    }
+}
+
+// Przygotowuje łamigłówkę: buduje tablice jednostek i klucze skrótów, a potem wczytuje
+// wskazówki i komórki stałe (puzzleLoad)
+int puzzleInit(Puzzle *pz, int n, const cell_t *givens, const unsigned char *fixed) {
+    int srn = (int)sqrt(n);
+    while (srn * srn < n) srn++;
+    if (srn * srn != n || n < 1 || n > MAX_N) return 0;
+    
+    pz->n = n;
+    pz->srn = srn;
+    pz->givens = malloc(n * n * sizeof(cell_t));
+    pz->fixed = malloc(n * n);
+    pz->units = malloc(3 * n * n * sizeof(int));
+    pz->rowOf = malloc(n * n * sizeof(int));
+    pz->colOf = malloc(n * n * sizeof(int));
+    pz->blockOf = malloc(n * n * sizeof(int));
+    pz->fixedCells = malloc(n * n * sizeof(int));
+    pz->freeCells = malloc(n * n * sizeof(int));
+    pz->blockStart = malloc((n + 1) * sizeof(int));
+    pz->blockFree = malloc(n * n * sizeof(int));
+    
+    for (int u = 0; u < n; u++) {
+        for (int k = 0; k < n; k++) {
+            pz->units[u * n + k] = u * n + k;
+            pz->units[(n + u) * n + k] = k * n + u;
+            int r = (u / srn) * srn + k / srn;
+            int c = (u % srn) * srn + k % srn;
+            pz->units[(2 * n + u) * n + k] = r * n + c;
+        }
+    }
+    
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            pz->rowOf[i * n + j] = i;
+            pz->colOf[i * n + j] = j;
+            pz->blockOf[i * n + j] = (i / srn) * srn + j / srn;
+        }
+    }
+    puzzleLoad(pz, givens, fixed);
+    
+    // Klucze Zobrista ze stałego ziarna - skróty nie zależą od ziarna przebiegu
+    Rng keys;
+    rngSeed(&keys, 0x5A0B21A7ULL, 0);
+    pz->zobrist = malloc((size_t)n * n * (n + 1) * sizeof(uint64_t));
+    for (int k = 0; k < n * n * (n + 1); k++) pz->zobrist[k] = rngNext(&keys);
+    
+    // Specjalizowane jądra wybierane raz, przy tworzeniu łamigłówki
+    pz->kernels = selectSolverKernels(n);
+    pz->blockOperators = 1;     // rozwiązywanie ustawia je z SolverParams (solverPuzzleView)
+    return 1;
+}
+
+// Łamigłówka z bieżącej planszy gry (globalne board i fixed)
+int puzzleFromBoard(Puzzle *pz) {
+    cell_t givens[MAX_N * MAX_N];
+    unsigned char fixedCells[MAX_N * MAX_N];
+    loadCells(board, givens);
+    for (int i = 0; i < N; i++)
+        for (int j = 0; j < N; j++)
+            fixedCells[i * N + j] = fixed[i][j] != 0;
+    return puzzleInit(pz, N, givens, fixedCells);
+}
+
+void puzzleFree(Puzzle *pz) {
+    free(pz->givens);
+    free(pz->fixed);
+    free(pz->units);
+    free(pz->rowOf);
+    free(pz->colOf);
+    free(pz->blockOf);
+    free(pz->fixedCells);
+    free(pz->freeCells);
+    free(pz->blockStart);
+    free(pz->blockFree);
+    free(pz->zobrist);
+}
+
+// Płytka kopia łamigłówki z przełącznikami z parametrów; dzieli tablice z oryginałem,
+// więc wiele przebiegów z różnymi parametrami może korzystać z jednej łamigłówki
+Puzzle solverPuzzleView(const Puzzle *pz, const SolverParams *params) {
+    Puzzle view = *pz;
+    view.blockOperators = params->blockOperators;
+    return view;
+}
+
+// ===== Wstępne rozwiązywanie przez propagację ograniczeń =====
+//
+// Przed algorytmem genetycznym wypełniane są komórki wymuszone logiką: pojedyncze
+// kandydatury (naked singles), ukryte pojedynki (hidden singles) oraz zablokowani
+// kandydaci (pointing / claiming). Kandydaci to maski bitowe; wypełnione komórki
+// stają się stałymi, więc GA przeszukuje mniejszą przestrzeń.
+
+int gaPresolve = 1;             // czy uruchamiać presolve (--presolve on|off)
+
+typedef struct {
+    int blanks;                 // puste komórki przed presolve
+    int filled;                 // komórki wypełnione przez presolve
+    int nakedSingles;
+    int hiddenSingles;
+    int lockedEliminations;     // kandydaci usunięci przez pointing/claiming
+    int solved;                 // plansza rozwiązana w całości
+    int contradiction;          // sprzeczne wskazówki lub komórka bez kandydatów
+} PresolveStats;
+
+typedef struct {
+    int n, srn;
+    cell_t *grid;
+    unsigned char *fixed;
+    mask_t rowUsed[MAX_N], colUsed[MAX_N], boxUsed[MAX_N];
+    mask_t eliminated[MAX_N * MAX_N];   // kandydaci wykluczeni technikami blokującymi
+    PresolveStats *stats;
+} Presolver;
+
+// Indeks k-tej komórki jednostki u (wiersze, kolumny, bloki)
+static inline int unitCell(int n, int srn, int u, int k) {
+    if (u < n) return u * n + k;
+    if (u < 2 * n) return k * n + (u - n);
+    int b = u - 2 * n;
+    return ((b / srn) * srn + k / srn) * n + (b % srn) * srn + k % srn;
+}
+
+static inline mask_t candidates(const Presolver *ps, int cell) {
+    int n = ps->n, r = cell / n, c = cell % n;
+    int b = (r / ps->srn) * ps->srn + c / ps->srn;
+    mask_t full = (((mask_t)1 << n) - 1);
+    return full & ~(ps->rowUsed[r] | ps->colUsed[c] | ps->boxUsed[b] | ps->eliminated[cell]);
+}
+
+// Wpisuje wartość do komórki; zwraca 0 przy sprzeczności
+static int placeValue(Presolver *ps, int cell, int val) {
+    int n = ps->n, r = cell / n, c = cell % n;
+    int b = (r / ps->srn) * ps->srn + c / ps->srn;
+    mask_t bit = ((mask_t)1 << (val - 1));
+    if ((ps->rowUsed[r] | ps->colUsed[c] | ps->boxUsed[b]) & bit) return 0;
+    ps->grid[cell] = val;
+    ps->fixed[cell] = 1;
+    ps->rowUsed[r] |= bit;
+    ps->colUsed[c] |= bit;
+    ps->boxUsed[b] |= bit;
+    ps->stats->filled++;
+    return 1;
+}
+
+// Naked singles: komórka z jednym kandydatem. Zwraca liczbę wpisów, -1 przy sprzeczności
+static int nakedSingles(Presolver *ps) {
+    int placed = 0;
+    for (int cell = 0; cell < ps->n * ps->n; cell++) {
+        if (ps->grid[cell]) continue;
+        mask_t cand = candidates(ps, cell);
+        if (cand == 0) return -1;
+        if ((cand & (cand - 1)) == 0) {
+            if (!placeValue(ps, cell, __builtin_ctzll(cand) + 1)) return -1;
+            ps->stats->nakedSingles++;
+            placed++;
+        }
+    }
+    return placed;
+}
+
+// Hidden singles: wartość mieszcząca się w jednostce tylko w jednej komórce
+static int hiddenSingles(Presolver *ps) {
+    int n = ps->n, placed = 0;
+    for (int u = 0; u < 3 * n; u++) {
+        for (int val = 1; val <= n; val++) {
+            mask_t bit = ((mask_t)1 << (val - 1));
+            int count = 0, where = -1, present = 0;
+            for (int k = 0; k < n; k++) {
+                int cell = unitCell(n, ps->srn, u, k);
+                if (ps->grid[cell] == val) { present = 1; break; }
+                if (!ps->grid[cell] && (candidates(ps, cell) & bit)) { count++; where = cell; }
+            }
+            if (present) continue;
+            if (count == 0) return -1;
+            if (count == 1) {
+                if (!placeValue(ps, where, val)) return -1;
+                ps->stats->hiddenSingles++;
+                placed++;
+            }
+        }
+    }
+    return placed;
+}
+
+// Usuwa kandydata z komórek jednostki u leżących poza blokiem b (lub poza linią, gdy u to blok)
+static int eliminateOutside(Presolver *ps, int u, mask_t bit, int keepUnit) {
+    int n = ps->n, removed = 0;
+    for (int k = 0; k < n; k++) {
+        int cell = unitCell(n, ps->srn, u, k);
+        if (ps->grid[cell] || !(candidates(ps, cell) & bit)) continue;
+        int r = cell / n, c = cell % n, b = (r / ps->srn) * ps->srn + c / ps->srn;
+        int inKeep = keepUnit < n ? r == keepUnit : keepUnit < 2 * n ? c == keepUnit - n : b == keepUnit - 2 * n;
+        if (inKeep) continue;
+        ps->eliminated[cell] |= bit;
+        removed++;
+    }
+    return removed;
+}
+
+// Zablokowani kandydaci: jeśli w bloku wartość mieści się tylko w jednej linii, znika
+// z tej linii poza blokiem (pointing); jeśli w linii tylko w jednym bloku - znika
+// z reszty bloku (claiming). Zwraca liczbę usuniętych kandydatów.
+static int lockedCandidates(Presolver *ps) {
+    int n = ps->n, srn = ps->srn, removed = 0;
+    for (int u = 0; u < 3 * n; u++) {
+        for (int val = 1; val <= n; val++) {
+            mask_t bit = ((mask_t)1 << (val - 1));
+            int row = -1, col = -1, box = -1, count = 0;
+            for (int k = 0; k < n; k++) {
+                int cell = unitCell(n, srn, u, k);
+                if (ps->grid[cell] || !(candidates(ps, cell) & bit)) continue;
+                int r = cell / n, c = cell % n, b = (r / srn) * srn + c / srn;
+                if (count++ == 0) { row = r; col = c; box = b; }
+                if (r != row) row = -2;
+                if (c != col) col = -2;
+                if (b != box) box = -2;
+            }
+            if (count < 2) continue;
+            if (u >= 2 * n) {
+                if (row >= 0) removed += eliminateOutside(ps, row, bit, u);
+                if (col >= 0) removed += eliminateOutside(ps, n + col, bit, u);
+            } else if (box >= 0) {
+                removed += eliminateOutside(ps, 2 * n + box, bit, u);
+            }
+        }
+    }
+    ps->stats->lockedEliminations += removed;
+    return removed;
+}
+
+// Propaguje ograniczenia na planszy grid (0 = pusta), wpisując wymuszone wartości
+// i oznaczając je w fixed. Zwraca 1, gdy plansza została rozwiązana w całości.
+int presolve(int n, cell_t *grid, unsigned char *fixed, PresolveStats *stats) {
+    Presolver ps;
+    ps.n = n;
+    ps.srn = (int)sqrt(n);
+    ps.grid = grid;
+    ps.fixed = fixed;
+    ps.stats = stats;
+    memset(stats, 0, sizeof(*stats));
+    memset(ps.rowUsed, 0, sizeof(ps.rowUsed));
+    memset(ps.colUsed, 0, sizeof(ps.colUsed));
+    memset(ps.boxUsed, 0, sizeof(ps.boxUsed));
+    memset(ps.eliminated, 0, sizeof(ps.eliminated));
+    
+    for (int cell = 0; cell < n * n; cell++) {
+        if (!grid[cell]) {
+            stats->blanks++;
+            continue;
+        }
+        int val = grid[cell];
+        int r = cell / n, c = cell % n, b = (r / ps.srn) * ps.srn + c / ps.srn;
+        mask_t bit = ((mask_t)1 << (val - 1));
+        if ((ps.rowUsed[r] | ps.colUsed[c] | ps.boxUsed[b]) & bit) {
+            stats->contradiction = 1;
+            return 0;
+        }
+        ps.rowUsed[r] |= bit;
+        ps.colUsed[c] |= bit;
+        ps.boxUsed[b] |= bit;
+    }
+    
+    // Najpierw tanie techniki; droższe dopiero, gdy tańsze nic nie dają
+    while (stats->filled < stats->blanks) {
+        int progress = nakedSingles(&ps);
+        if (progress == 0) progress = hiddenSingles(&ps);
+        if (progress == 0) progress = lockedCandidates(&ps);
+        if (progress < 0) {
+            stats->contradiction = 1;
+            return 0;
+        }
+        if (progress == 0) break;
+    }
+    
+    stats->solved = stats->filled == stats->blanks;
+    return stats->solved;
+}
+
+// Wypełnia puste komórki osobnika losowymi wartościami zgodnymi z blokami:
+// w każdym bloku brakujące liczby są tasowane i rozkładane na wolne komórki
+void initialize_solution_randomly(const Puzzle *pz, Individual *ind, Rng *rng) {
+    int n = pz->n, srn = pz->srn;
+    cell_t *grid = ind->grid;
+    memcpy(grid, pz->givens, n * n * sizeof(cell_t));
+    
+    for (int block_row = 0; block_row < srn; block_row++) {
+        for (int block_col = 0; block_col < srn; block_col++) {
+            int used[n+1];
+            for (int u = 0; u <= n; u++) used[u] = 0;
+            
+            // Zaznacz już używane liczby w bloku
+            for (int r = 0; r < srn; r++) {
+                for (int c = 0; c < srn; c++) {
+                    int val = grid[(block_row*srn + r) * n + block_col*srn + c];
+                    if (val != 0) used[val] = 1;
+                }
+            }
+            
+            // Wymieszaj brakujące wartości i rozłóż je na wolne komórki bloku
+            int values[n];
+            int missing = 0;
+            for (int v = 1; v <= n; v++)
+                if (!used[v]) values[missing++] = v;
+            for (int k = missing - 1; k > 0; k--) {
+                int swap = rngInt(rng, k + 1);
+                int tmp = values[k];
+                values[k] = values[swap];
+                values[swap] = tmp;
+            }
+            
+            int next = 0;
+            for (int r = 0; r < srn; r++) {
+                for (int c = 0; c < srn; c++) {
+                    int idx = (block_row*srn + r) * n + block_col*srn + c;
+                    if (grid[idx] == 0 && !pz->fixed[idx]) {
+                        grid[idx] = values[next++];
+                    }
+                }
+            }
+        }
+    }
+    
+    recountIndividual(pz, ind);
+    ind->hash = genomeHash(pz, grid);
+}
+
+// Inicjalizuje populację
+void initializePopulation(const Puzzle *pz, Population *pop, Rng *rng) {
+    for (int i = 0; i < pop->size; i++) {
+        initialize_solution_randomly(pz, &pop->members[i], rng);
+    }
+}
+
+// Tablica aliasów Walkera: losowanie z rozkładu dyskretnego w O(1)
+typedef struct {
+    double *prob;       // próg akceptacji dla każdego kubełka
+    int *alias;         // osobnik zastępczy dla każdego kubełka
+    int *work;          // stos roboczy (małe od początku, duże od końca)
+    int size;
+} AliasTable;
+
+void allocAliasTable(AliasTable *table, int size) {
+    table->size = size;
+    table->prob = malloc(size * sizeof(double));
+    table->alias = malloc(size * sizeof(int));
+    table->work = malloc(size * sizeof(int));
+    PROFILE_ALLOC(3);
+}
+
+void freeAliasTable(AliasTable *table) {
+    free(table->prob);
+    free(table->alias);
+    free(table->work);
+}
+
+// Buduje tablicę aliasów dla wag 1/(fitness+1) całej populacji (metoda Vose'a, O(P))
+void buildAliasTable(AliasTable *table, const Population *pop) {
+    int n = table->size;
+    double total = 0;
+    for (int i = 0; i < n; i++) {
+        total += 1.0 / (pop->members[i].fitness + 1);
+    }
+    
+    int small = 0, large = n;
+    for (int i = 0; i < n; i++) {
+        table->prob[i] = (double)n / (pop->members[i].fitness + 1) / total;
+        table->alias[i] = i;
+        if (table->prob[i] < 1.0) table->work[small++] = i;
+        else table->work[--large] = i;
+    }
+    
+    while (small > 0 && large < n) {
+        int s = table->work[--small];
+        int l = table->work[large];
+        table->alias[s] = l;
+        table->prob[l] -= 1.0 - table->prob[s];
+        if (table->prob[l] < 1.0) {
+            large++;
+            table->work[small++] = l;
+        }
+    }
+    
+    // Pozostałe kubełki (błędy zaokrągleń) zawsze akceptują siebie
+    while (small > 0) table->prob[table->work[--small]] = 1.0;
+    while (large < n) table->prob[table->work[large++]] = 1.0;
+}
+
+// Stan selekcji jednego pokolenia - przygotowywany raz, czytany przez wszystkie wątki
+typedef struct {
+    Population *population;
+    AliasTable roulette;
+    int tournamentSize;
+} Selector;
+
+// Strategia selekcji rodzica - wymienne przez --selection
+typedef struct {
+    const char *name;
+    Individual *(*select)(const Selector *sel, Rng *rng);
+    int usesRoulette;   // czy wymaga tablicy aliasów
+} SelectionStrategy;
+
+// Selekcja turniejowa
+Individual* tournamentSelection(const Selector *sel, Rng *rng) {
+    Population *pop = sel->population;
+    Individual *best = &pop->members[rngInt(rng, pop->size)];
+    for (int i = 1; i < sel->tournamentSize; i++) {
+        Individual *contender = &pop->members[rngInt(rng, pop->size)];
+        if (contender->fitness < best->fitness) {
+            best = contender;
+        }
+    }
+    return best;
+}
+
+// Selekcja ruletkowa (proporcjonalna do fitness) - losowanie z tablicy aliasów w O(1)
+Individual* rouletteWheelSelection(const Selector *sel, Rng *rng) {
+    const AliasTable *table = &sel->roulette;
+    int i = rngInt(rng, table->size);
+    if (rngDouble(rng) >= table->prob[i]) i = table->alias[i];
+    return &sel->population->members[i];
+}
+
+const SelectionStrategy selectionStrategies[] = {
+    { "tournament", tournamentSelection, 0 },
+    { "roulette", rouletteWheelSelection, 1 },
+};
+
+// Strategie wyboru pierwszego i drugiego rodzica
+const SelectionStrategy *parentSelection[2] = { &selectionStrategies[0], &selectionStrategies[1] };
+
+// Wyszukuje strategię po nazwie; NULL gdy nie istnieje
+const SelectionStrategy *findSelectionStrategy(const char *name) {
+    for (size_t i = 0; i < sizeof(selectionStrategies) / sizeof(selectionStrategies[0]); i++) {
+        if (strcmp(selectionStrategies[i].name, name) == 0) return &selectionStrategies[i];
+    }
+    return NULL;
+}
+
+// Przygotowanie selekcji na dane pokolenie; tablica aliasów tylko gdy używa jej któraś strategia
+void prepareSelection(Selector *sel, Population *pop, const SelectionStrategy *const strategies[2]) {
+    sel->population = pop;
+    if (strategies[0]->usesRoulette || strategies[1]->usesRoulette) {
+        buildAliasTable(&sel->roulette, pop);
+    }
+}
+
+// Znajdź najlepszego osobnika w populacji
+Individual* findBestIndividual(Population *pop) {
+    Individual *best = &pop->members[0];
+    for (int i = 1; i < pop->size; i++) {
+        if (pop->members[i].fitness < best->fitness) {
+            best = &pop->members[i];
+        }
+    }
+    return best;
+}
+
+// Kopiuje eliteCount najlepszych osobników do dest w kolejności rosnącego fitness.
+// Fitness to mała liczba całkowita, więc wystarcza sortowanie przez zliczanie w O(P + maxFitness)
+void copyElite(const Puzzle *pz, Population *pop, Population *dest, int eliteCount, int *histogram, int maxFitness) {
+    for (int f = 0; f <= maxFitness; f++) histogram[f] = 0;
+    for (int i = 0; i < pop->size; i++) histogram[pop->members[i].fitness]++;
+    
+    // Zamień liczności na pozycje startowe, aż do progu obejmującego elitę
+    int threshold = 0, position = 0;
+    for (; threshold <= maxFitness; threshold++) {
+        int count = histogram[threshold];
+        histogram[threshold] = position;
+        position += count;
+        if (position >= eliteCount) break;
+    }
+    
+    // Jeden przebieg po populacji - osobniki ponad progiem są pomijane
+    for (int i = 0; i < pop->size; i++) {
+        int f = pop->members[i].fitness;
+        if (f <= threshold && histogram[f] < eliteCount) {
+            copyIndividual(pz, &pop->members[i], &dest->members[histogram[f]++]);
+        }
+    }
+}
+
+// ===== Krok memetyczny =====
+//
+// Mutacja rzadko trafia w kilka ostatnich konfliktów, więc GA często utyka tuż nad zerem.
+// Z --local-search K dzieci po mutacji przechodzą do K kroków min-conflicts (jądro
+// localSearch): zamiany w bloku, które zmniejszają konflikty w wierszach i kolumnach,
+// z przyrostową oceną. Z --local-search-top P przeszukiwane są tylko dzieci nie gorsze od
+// progu, poniżej którego leży P% bieżącej populacji. Domyślnie wszystkie: na trudnych 9x9
+// i 16x16 zawężenie do 10% traciło większość zysku.
+
+#define LOCAL_SEARCH_BUDGET 50  // budżet silnika "ma" w benchmarku, gdy nie podano --local-search
+
+int gaLocalSearch = 0;          // domyślny budżet kroków na dziecko (--local-search); 0 = wyłączone
+double gaLocalSearchShare = 1.0;    // domyślny ułamek najlepszych (--local-search-top w procentach)
+
+// Najmniejszy fitness f, przy którym osobniki o fitness <= f stanowią co najmniej share populacji
+int fitnessQuantile(const Population *pop, double share, int *histogram, int maxFitness) {
+    for (int f = 0; f <= maxFitness; f++) histogram[f] = 0;
+    for (int i = 0; i < pop->size; i++) histogram[pop->members[i].fitness]++;
+    int target = (int)ceil(share * pop->size), position = 0;
+    if (target < 1) target = 1;
+    for (int f = 0; f <= maxFitness; f++) {
+        position += histogram[f];
+        if (position >= target) return f;
+    }
+    return maxFitness;
+}
+
+// ===== Skróty genomów =====
+//
+// Każdy osobnik niesie 64-bitowy skrót Zobrista planszy, aktualizowany przyrostowo przy
+// zamianach, mutacjach i krzyżowaniu. Raz na pokolenie skróty bieżącej populacji trafiają
+// do tablicy z adresowaniem otwartym (tylko do odczytu podczas produkcji potomstwa, więc
+// wątki nie potrzebują synchronizacji). Dziecko identyczne z osobnikiem populacji przejmuje
+// jego fitness i nie trafia do partii oceny. Duplikat, którego mutacja nie zmieniła (skrót
+// bez zmian), dostaje dodatkowe zamiany (do DEDUP_RETRIES prób).
+// Zgodność skrótu zawsze potwierdza porównanie plansz.
+
+#define DEDUP_RETRIES 3
+
+int gaDedup = 1;                // domyślnie pomijać ocenę duplikatów i mutować klony (--dedup)
+
+typedef struct {
+    const Population *population;
+    int *slots;                 // indeksy osobników, -1 = wolne miejsce
+    int mask;                   // rozmiar tablicy - 1 (potęga dwójki)
+} GenomeSet;
+
+void allocGenomeSet(GenomeSet *set, int count) {
+    int size = 1;
+    while (size < 2 * count) size *= 2;
+    set->slots = malloc(size * sizeof(int));
+    set->mask = size - 1;
+    set->population = NULL;
+    PROFILE_ALLOC(1);
+}
+
+void freeGenomeSet(GenomeSet *set) {
+    free(set->slots);
+    set->slots = NULL;
+}
+
+// Wstawia skróty populacji; osobniki o powtórzonym skrócie są pomijane
+void buildGenomeSet(GenomeSet *set, const Population *pop) {
+    set->population = pop;
+    memset(set->slots, 0xff, (set->mask + 1) * sizeof(int));
+    for (int i = 0; i < pop->size; i++) {
+        uint64_t hash = pop->members[i].hash;
+        int slot = hash & set->mask;
+        while (set->slots[slot] >= 0 && pop->members[set->slots[slot]].hash != hash) {
+            slot = (slot + 1) & set->mask;
+        }
+        set->slots[slot] = i;
+    }
+}
+
+// Osobnik populacji identyczny z ind albo NULL
+const Individual *findGenome(const GenomeSet *set, const Puzzle *pz, const Individual *ind) {
+    const Population *pop = set->population;
+    for (int slot = ind->hash & set->mask; set->slots[slot] >= 0; slot = (slot + 1) & set->mask) {
+        const Individual *other = &pop->members[set->slots[slot]];
+        if (other->hash == ind->hash) {
+            return memcmp(other->grid, ind->grid, pz->n * pz->n * sizeof(cell_t)) == 0 ? other : NULL;
+        }
+    }
+    return NULL;
+}
+
+// Stan pojedynczego przebiegu algorytmu genetycznego współdzielony przez wątki
+typedef struct GAContext GAContext;
+
+// Wątek roboczy produkujący potomstwo dla stałego zakresu par
+typedef struct {
+    GAContext *ga;
+    int firstPair, lastPair;    // zakres par [firstPair, lastPair)
+    Rng rng;                    // własny strumień losowy wątku
+    Individual *best;           // najlepsze dziecko z ostatniego pokolenia
+    long saved;                 // oceny pominięte w bieżącym pokoleniu (duplikaty)
+    long clones;                // klony zmutowane ponownie w bieżącym pokoleniu
+    long localMoves;            // zamiany lokalnego przeszukiwania w bieżącym pokoleniu
+    EvalBatch batch;            // dzieci czekające na ocenę (do 2 na parę)
+    Individual **pending;       // dziecko na każdej pozycji partii
+    PhaseTimes times;           // czasy faz w bieżącym pokoleniu (GA_PROFILE)
+    pthread_t thread;
+} GAWorker;
+
+struct GAContext {
+    const Puzzle *puzzle;
+    SolverParams params;        // parametry przebiegu (kopia - przebiegi mogą się różnić)
+    const SelectionStrategy *selection[2];  // strategie wyboru rodziców
+    Population population, newPopulation;
+    Selector selector;
+    GenomeSet genomes;          // skróty bieżącej populacji
+    EvalKernel evalKernel;      // jądro oceny partii potomstwa (selectEvalKernel)
+    int *histogram;             // bufor do wyboru elity
+    int maxFitness;
+    int eliteCount;
+    int generation;             // liczba ukończonych pokoleń
+    Individual *best;           // najlepszy osobnik bieżącej populacji
+    int stop;                   // sygnał zakończenia dla wątków
+    GAWorker *workers;
+    int workerCount;
+    pthread_barrier_t start, done;
+    PhaseTimes times;           // czasy faz ostatniego pokolenia, suma po wątkach
+    PhaseTimes totalTimes;      // czasy faz całego przebiegu
+    double mutationRate;        // bieżące prawdopodobieństwo mutacji komórki
+    double logKeep;             // log(1 - mutationRate) dla losowania geometrycznego
+    int epochBest;              // najlepszy fitness od startu lub ostatniego restartu
+    int lastImprovement;        // pokolenie ostatniej poprawy epochBest
+    cell_t *record;             // najlepsza plansza całego przebiegu (przeżywa restarty)
+    int recordFitness;
+    int boosts;                 // ile razy z rzędu podniesiono mutację
+    int restarts;               // liczba częściowych restartów
+    long evaluationsSaved;      // oceny pominięte dzięki skrótom genomów
+    long clonesMutated;         // dzieci-klony zmutowane ponownie
+    int localThreshold;         // dzieci o fitness do tego progu przechodzą lokalne przeszukiwanie; -1 = żadne
+    long localSearchMoves;      // zamiany wykonane przez lokalne przeszukiwanie
+};
+
+// Wynik przebiegu algorytmu
+typedef struct {
+    int fitness;                // konflikty najlepszego osobnika
+    int generations;            // liczba wykonanych pokoleń (wyżarzanie: ruchów)
+    long evaluations;           // liczba ocen rozwiązań
+    long evaluationsSaved;      // w tym pominiętych, bo dziecko było duplikatem
+    double seconds;             // czas rozwiązywania
+    cell_t grid[MAX_N * MAX_N]; // najlepsza znaleziona plansza
+} GAResult;
+
+// Dziecko identyczne z osobnikiem populacji przejmuje jego fitness.
+// Zwraca 1, gdy dziecko jest duplikatem (i nie wymaga oceny)
+static int adoptTwin(const GAContext *ga, Individual *child) {
+    const Individual *twin = ga->params.dedup ? findGenome(&ga->genomes, ga->puzzle, child) : NULL;
+    if (!twin) return 0;
+    child->fitness = twin->fitness;
+    return 1;
+}
+
+// Dziecko-duplikat (kopia rodzica albo bliźniak z adoptTwin), którego mutacja nie
+// zmieniła, dostaje losowe zamiany w blokach. Zwraca 1, gdy dziecko było klonem
+static int diversifyChild(const GAContext *ga, Individual *child, uint64_t original, Rng *rng) {
+    const Puzzle *pz = ga->puzzle;
+    if (child->hash != original || pz->freeCount == 0) return 0;
+    for (int attempt = 0; attempt < DEDUP_RETRIES && child->hash == original; attempt++) {
+        int cell = pz->freeCells[rngInt(rng, pz->freeCount)];
+        int block = pz->blockOf[cell];
+        int first = pz->blockStart[block];
+        swapGenes(pz, child, cell, pz->blockFree[first + rngInt(rng, pz->blockStart[block + 1] - first)]);
+    }
+    return 1;
+}
+
+// Dziecko po mutacji: fitness znany (niezmieniony duplikat albo bliźniak osobnika
+// populacji) albo dziecko trafia do partii oceny. Zwraca 1, gdy ocenę pominięto
+static int queueChild(const GAContext *ga, GAWorker *worker, Individual *child, int known, uint64_t original) {
+    if ((known && child->hash == original) || adoptTwin(ga, child)) return 1;
+    packIndividual(ga->puzzle, child, &worker->batch, worker->batch.count);
+    worker->pending[worker->batch.count++] = child;
+    return 0;
+}
+
+// Wypełnia miejsca po elicie w nowej populacji: selekcja, krzyżowanie, mutacja, ocena.
+// Krzyżowanie i mutacja zmieniają tylko plansze i skróty; dzieci o nieznanym fitness
+// ocenia potem jedno wywołanie jądra partii. Każdy wątek pisze wyłącznie do swoich
+// miejsc i losuje tylko ze swojego strumienia, więc wynik zależy jedynie od ziarna
+// i liczby wątków.
+void produceOffspring(GAContext *ga, GAWorker *worker) {
+    const Puzzle *pz = ga->puzzle;
+    Population *newPopulation = &ga->newPopulation;
+    Individual *scratch = &newPopulation->members[newPopulation->size];
+    Rng *rng = &worker->rng;
+    PhaseTimes *times = &worker->times;
+    EvalBatch *batch = &worker->batch;
+    double logKeep = ga->logKeep;
+    worker->best = NULL;
+    worker->saved = 0;
+    worker->clones = 0;
+    worker->localMoves = 0;
+    batch->count = 0;
+    memset(times, 0, sizeof(*times));
+    
+    for (int pair = worker->firstPair; pair < worker->lastPair; pair++) {
+        int i = ga->eliteCount + 2 * pair;
+        
+        // Selekcja rodziców (można wybrać różne metody)
+        PROFILE_START(selectStart);
+        Individual *parent1 = ga->selection[0]->select(&ga->selector, rng);
+        Individual *parent2 = ga->selection[1]->select(&ga->selector, rng);
+        PROFILE_STOP(times, PHASE_SELECT, selectStart);
+        
+        // Dzieci zapisywane są bezpośrednio w następnym buforze;
+        // przy nieparzystej liczbie miejsc drugie dziecko trafia do bufora roboczego
+        Individual *child1 = &newPopulation->members[i];
+        Individual *child2 = i + 1 < newPopulation->size ? &newPopulation->members[i + 1] : scratch;
+        
+        // Krzyżowanie (można wybrać różne metody); twin1/twin2 - czy dziecko jest duplikatem
+        // (wtedy jego fitness jest znany)
+        PROFILE_START(crossoverStart);
+        int twin1 = 1, twin2 = 1;
+        if (rngDouble(rng) < ga->params.crossoverRate) {
+            int crossover = ga->params.crossover;
+            if (crossover == SOLVER_CROSSOVER_MIXED) {
+                crossover = rngInt(rng, 2) == 0 ? SOLVER_CROSSOVER_POINT : SOLVER_CROSSOVER_BLOCK;
+            }
+            if (crossover == SOLVER_CROSSOVER_POINT) {
+                if (pz->blockOperators) bandCrossover(pz, parent1, parent2, child1, child2, rng);
+                else singlePointCrossover(pz, parent1, parent2, child1, child2, rng);
+            } else {
+                blockCrossover(pz, parent1, parent2, child1, child2, rng);
+            }
+            PROFILE_STOP(times, PHASE_CROSSOVER, crossoverStart);
+            
+            PROFILE_START(evaluateStart);
+            twin1 = adoptTwin(ga, child1);
+            twin2 = adoptTwin(ga, child2);
+            PROFILE_STOP(times, PHASE_EVALUATE, evaluateStart);
+        } else {
+            copyIndividual(pz, parent1, child1);
+            copyIndividual(pz, parent2, child2);
+            PROFILE_STOP(times, PHASE_CROSSOVER, crossoverStart);
+        }
+        
+        // Mutacja (można wybrać różne metody). Operatory blokowe używają tylko zamian w bloku
+        PROFILE_START(mutateStart);
+        uint64_t hash1 = child1->hash, hash2 = child2->hash;
+        if (pz->blockOperators || rngInt(rng, 2) == 0) {
+            swapMutation(pz, child1, rng, logKeep);
+            swapMutation(pz, child2, rng, logKeep);
+        } else {
+            randomResetMutation(pz, child1, rng, logKeep);
+            randomResetMutation(pz, child2, rng, logKeep);
+        }
+        if (ga->params.dedup && twin1) worker->clones += diversifyChild(ga, child1, hash1, rng);
+        if (ga->params.dedup && twin2 && child2 != scratch) worker->clones += diversifyChild(ga, child2, hash2, rng);
+        PROFILE_STOP(times, PHASE_MUTATE, mutateStart);
+        
+        // Dziecko w buforze roboczym nie trafia do populacji - nie wymaga oceny
+        PROFILE_START(queueStart);
+        worker->saved += queueChild(ga, worker, child1, twin1, hash1);
+        if (child2 != scratch) worker->saved += queueChild(ga, worker, child2, twin2, hash2);
+        PROFILE_STOP(times, PHASE_EVALUATE, queueStart);
+    }
+    
+    // Ocena partii; przy operatorach blokowych bloki są permutacjami, więc liczą się
+    // tylko wiersze, kolumny i stałe duplikaty wskazówek (jak w recountIndividual)
+    PROFILE_START(evaluateStart);
+    batch->units = (pz->blockOperators ? 2 : 3) * pz->n;
+    batch->baseFitness = pz->blockOperators ? pz->givenBlockConflicts : 0;
+    if (batch->count > 0) ga->evalKernel(pz, batch);
+    for (int b = 0; b < batch->count; b++) worker->pending[b]->fitness = batch->fitness[b];
+    PROFILE_STOP(times, PHASE_EVALUATE, evaluateStart);
+    
+    for (int pair = worker->firstPair; pair < worker->lastPair; pair++) {
+        int i = ga->eliteCount + 2 * pair;
+        Individual *child1 = &newPopulation->members[i];
+        Individual *child2 = i + 1 < newPopulation->size ? &newPopulation->members[i + 1] : scratch;
+        
+        // Krok memetyczny - tylko dzieci nie gorsze od progu z bieżącej populacji;
+        // przeszukiwanie potrzebuje liczności, więc najpierw liczy je od nowa
+        if (ga->localThreshold >= 0) {
+            PROFILE_START(localStart);
+            int budget = ga->params.localSearch;
+            if (child1->fitness <= ga->localThreshold) {
+                recountIndividual(pz, child1);
+                worker->localMoves += localSearch(pz, child1, rng, budget);
+            }
+            if (child2 != scratch && child2->fitness <= ga->localThreshold) {
+                recountIndividual(pz, child2);
+                worker->localMoves += localSearch(pz, child2, rng, budget);
+            }
+            PROFILE_STOP(times, PHASE_LOCAL, localStart);
+        }
+        
+        if (!worker->best || child1->fitness < worker->best->fitness) worker->best = child1;
+        if (child2 != scratch && child2->fitness < worker->best->fitness) worker->best = child2;
+    }
+}
+
+// Pętla wątku roboczego: czeka na start pokolenia, produkuje swoją część, zgłasza koniec
+void *offspringWorker(void *arg) {
+    GAWorker *worker = arg;
+    GAContext *ga = worker->ga;
+    while (1) {
+        pthread_barrier_wait(&ga->start);
+        if (ga->stop) break;
+        produceOffspring(ga, worker);
+        pthread_barrier_wait(&ga->done);
+    }
+    return NULL;
+}
+
+// Parametry, liczniki i generatory przebiegu bez ruszania populacji (checkpointLoad
+// wczytuje ją z pliku). Nieznana nazwa strategii selekcji oznacza turniej.
+static void gaResetState(GAContext *ga, const SolverParams *params, uint64_t streamBase) {
+    ga->params = *params;
+    for (int k = 0; k < 2; k++) {
+        const char *name = params->selection[k] ? params->selection[k] : "tournament";
+        ga->selection[k] = findSelectionStrategy(name);
+        if (!ga->selection[k]) ga->selection[k] = &selectionStrategies[0];
+    }
+    ga->generation = 0;
+    memset(&ga->times, 0, sizeof(ga->times));
+    memset(&ga->totalTimes, 0, sizeof(ga->totalTimes));
+    ga->mutationRate = params->mutationRate;
+    ga->logKeep = log(1.0 - params->mutationRate);
+    ga->lastImprovement = 0;
+    ga->boosts = 0;
+    ga->restarts = 0;
+    ga->evaluationsSaved = 0;
+    ga->clonesMutated = 0;
+    ga->localThreshold = -1;
+    ga->localSearchMoves = 0;
+    ga->selector.tournamentSize = params->tournamentSize < 1 ? 1 : params->tournamentSize;
+    for (int t = 0; t < ga->workerCount; t++) {
+        rngSeed(&ga->workers[t].rng, params->seed, streamBase + t);
+    }
+}
+
+// Stan początkowy przebiegu na istniejących arenach: parametry, generatory i losowa
+// populacja. Rozmiar populacji i liczba wątków muszą być takie jak przy gaInit, łamigłówka
+// (ga->puzzle) może mieć nowe wskazówki tego samego rozmiaru.
+void gaReset(GAContext *ga, const SolverParams *params, uint64_t streamBase) {
+    const Puzzle *pz = ga->puzzle;
+    gaResetState(ga, params, streamBase);
+    initializePopulation(pz, &ga->population, &ga->workers[0].rng);
+    ga->best = findBestIndividual(&ga->population);
+    ga->epochBest = ga->best->fitness;
+    memcpy(ga->record, ga->best->grid, pz->n * pz->n * sizeof(cell_t));
+    ga->recordFitness = ga->best->fitness;
+}
+
+// Liczba elity dla populacji; co najmniej jedna para potomstwa zostaje zawsze
+int eliteCountFor(int populationSize, double elitismRate) {
+    int eliteCount = populationSize * elitismRate;
+    if (eliteCount > populationSize - 2) eliteCount = populationSize - 2;
+    return eliteCount < 0 ? 0 : eliteCount;
+}
+
+// Areny, bufory i wątki przebiegu - bez stanu początkowego (gaReset lub checkpointLoad)
+static void gaAllocate(GAContext *ga, const Puzzle *pz, const SolverParams *params) {
+    int populationSize = params->populationSize < 2 ? 2 : params->populationSize;
+    int threads = params->threads;
+    
+    // Dwie areny: bieżące i następne pokolenie, zamieniane rolami co pokolenie.
+    // Po starcie pętla GA nie wykonuje już żadnych alokacji.
+    ga->puzzle = pz;
+    allocPopulation(&ga->population, populationSize, pz);
+    allocPopulation(&ga->newPopulation, populationSize, pz);
+    ga->eliteCount = eliteCountFor(populationSize, params->elitismRate);
+    ga->stop = 0;
+    allocGenomeSet(&ga->genomes, populationSize);
+    allocAliasTable(&ga->selector.roulette, populationSize);
+    
+    // Histogram do wyboru elity - fitness nie przekracza 3 * n * n
+    ga->maxFitness = 3 * pz->n * pz->n;
+    ga->histogram = malloc((ga->maxFitness + 1) * sizeof(int));
+    
+    // Pary potomstwa dzielone po równo między wątki; wątek 0 to wątek wywołujący
+    int pairCount = (populationSize - ga->eliteCount + 1) / 2;
+    ga->workerCount = threads < 1 ? 1 : threads;
+    ga->workers = malloc(ga->workerCount * sizeof(GAWorker));
+    ga->record = malloc(pz->n * pz->n * sizeof(cell_t));
+    PROFILE_ALLOC(3);   // histogram, wątki i najlepsza plansza
+    ga->evalKernel = selectEvalKernel(pz, NULL);
+    for (int t = 0; t < ga->workerCount; t++) {
+        GAWorker *worker = &ga->workers[t];
+        worker->ga = ga;
+        worker->firstPair = (long)pairCount * t / ga->workerCount;
+        worker->lastPair = (long)pairCount * (t + 1) / ga->workerCount;
+        int children = 2 * (worker->lastPair - worker->firstPair);
+        allocEvalBatch(pz, &worker->batch, children);
+        worker->pending = malloc((children > 0 ? children : 1) * sizeof(Individual *));
+    }
+    PROFILE_ALLOC(3 * ga->workerCount);    // partie oceny potomstwa
+    
+    // Wątki czekają na barierze start, więc stan przebiegu można ustawić po ich utworzeniu
+    pthread_barrier_init(&ga->start, NULL, ga->workerCount);
+    pthread_barrier_init(&ga->done, NULL, ga->workerCount);
+    for (int t = 1; t < ga->workerCount; t++) {
+        pthread_create(&ga->workers[t].thread, NULL, offspringWorker, &ga->workers[t]);
+    }
+}
+
+// Przygotowuje przebieg: areny, wątki i populację początkową (gaReset).
+// Strumienie losowe wątków wyprowadzane są z params->seed i numeru strumienia streamBase + t.
+void gaInit(GAContext *ga, const Puzzle *pz, const SolverParams *params, uint64_t streamBase) {
+    gaAllocate(ga, pz, params);
+    gaReset(ga, params, streamBase);
+}
+
+// ===== Reakcja na stagnację =====
+//
+// Gdy najlepszy fitness nie poprawia się przez params.stagnationLimit pokoleń, prawdopodobieństwo
+// mutacji rośnie dwukrotnie (do STAGNATION_MAX_RATE). Po STAGNATION_BOOSTS nieudanych
+// podniesieniach cała populacja jest losowana od nowa blokami, jak przy inicjalizacji,
+// a mutacja wraca do wartości bazowej. Elita nie przeżywa restartu - jej kopie ściągały
+// nowe osobniki z powrotem do tego samego minimum lokalnego - ale najlepsza plansza
+// przebiegu zostaje w record. Przebieg trwa dalej bez przerwy.
+
+#define STAGNATION_BOOSTS 1
+#define STAGNATION_MAX_RATE 0.5
+
+int gaStagnationLimit = 300;    // domyślny limit pokoleń bez poprawy (--stagnation); 0 = wyłączone
+
+void setMutationRate(GAContext *ga, double rate) {
+    ga->mutationRate = rate;
+    ga->logKeep = log(1.0 - rate);
+}
+
+// Losuje od nowa całą populację
+void restartPopulation(GAContext *ga) {
+    Population *pop = &ga->population;
+    for (int i = 0; i < pop->size; i++) {
+        initialize_solution_randomly(ga->puzzle, &pop->members[i], &ga->workers[0].rng);
+    }
+    ga->best = findBestIndividual(pop);
+    ga->epochBest = ga->best->fitness;
+    ga->restarts++;
+}
+
+void checkStagnation(GAContext *ga) {
+    if (ga->best->fitness < ga->recordFitness) {
+        memcpy(ga->record, ga->best->grid, ga->puzzle->n * ga->puzzle->n * sizeof(cell_t));
+        ga->recordFitness = ga->best->fitness;
+    }
+    if (ga->best->fitness < ga->epochBest) {
+        ga->epochBest = ga->best->fitness;
+        ga->lastImprovement = ga->generation;
+        if (ga->boosts > 0) setMutationRate(ga, ga->params.mutationRate);
+        ga->boosts = 0;
+        return;
+    }
+    int limit = ga->params.stagnationLimit;
+    if (limit <= 0 || ga->generation - ga->lastImprovement < limit) return;
+    
+    ga->lastImprovement = ga->generation;
+    if (ga->boosts < STAGNATION_BOOSTS) {
+        ga->boosts++;
+        setMutationRate(ga, fmin(ga->mutationRate * 2, STAGNATION_MAX_RATE));
+    } else {
+        ga->boosts = 0;
+        setMutationRate(ga, ga->params.mutationRate);
+        restartPopulation(ga);
+    }
+}
+
+// Jedno pokolenie: elita, selekcja, potomstwo, zamiana buforów
+void gaGeneration(GAContext *ga) {
+    PhaseTimes *times = &ga->times;
+    memset(times, 0, sizeof(*times));
+    
+    // Elitaryzm - przenieś najlepsze osobniki do nowej populacji
+    PROFILE_START(eliteStart);
+    copyElite(ga->puzzle, &ga->population, &ga->newPopulation, ga->eliteCount, ga->histogram, ga->maxFitness);
+    PROFILE_STOP(times, PHASE_ELITE, eliteStart);
+    
+    // Wagi selekcji liczone raz na pokolenie, nie przy każdym losowaniu
+    PROFILE_START(prepareStart);
+    prepareSelection(&ga->selector, &ga->population, ga->selection);
+    if (ga->params.dedup) buildGenomeSet(&ga->genomes, &ga->population);
+    ga->localThreshold = ga->params.localSearch <= 0 ? -1 :
+        fitnessQuantile(&ga->population, ga->params.localSearchShare, ga->histogram, ga->maxFitness);
+    PROFILE_STOP(times, PHASE_PREPARE, prepareStart);
+    
+    // Wypełnij resztę nowej populacji poprzez selekcję, krzyżowanie i mutację
+    if (ga->workerCount > 1) pthread_barrier_wait(&ga->start);
+    produceOffspring(ga, &ga->workers[0]);
+    if (ga->workerCount > 1) pthread_barrier_wait(&ga->done);
+    
+    // Najlepszy osobnik nowego pokolenia to najlepsza elita lub któreś z dzieci
+    ga->best = &ga->newPopulation.members[0];
+    for (int t = 0; t < ga->workerCount; t++) {
+        Individual *best = ga->workers[t].best;
+        if (best && (ga->eliteCount == 0 || best->fitness < ga->best->fitness)) ga->best = best;
+        ga->evaluationsSaved += ga->workers[t].saved;
+        ga->clonesMutated += ga->workers[t].clones;
+        ga->localSearchMoves += ga->workers[t].localMoves;
+    }
+#if GA_PROFILE
+    for (int t = 0; t < ga->workerCount; t++) addPhaseTimes(times, &ga->workers[t].times);
+    addPhaseTimes(&ga->totalTimes, times);
+#endif
+    
+    // Zamień role buforów - nowa populacja staje się bieżącą
+    Population temp = ga->population;
+    ga->population = ga->newPopulation;
+    ga->newPopulation = temp;
+    ga->generation++;
+    checkStagnation(ga);
+}
+
+// Zatrzymuje wątki i zwalnia pamięć przebiegu
+void gaFree(GAContext *ga) {
+    ga->stop = 1;
+    if (ga->workerCount > 1) pthread_barrier_wait(&ga->start);
+    for (int t = 1; t < ga->workerCount; t++) {
+        pthread_join(ga->workers[t].thread, NULL);
+    }
+    pthread_barrier_destroy(&ga->start);
+    pthread_barrier_destroy(&ga->done);
+    
+    for (int t = 0; t < ga->workerCount; t++) {
+        freeEvalBatch(&ga->workers[t].batch);
+        free(ga->workers[t].pending);
+    }
+    free(ga->histogram);
+    free(ga->workers);
+    free(ga->record);
+    freeGenomeSet(&ga->genomes);
+    freeAliasTable(&ga->selector.roulette);
+    freePopulation(&ga->population);
+    freePopulation(&ga->newPopulation);
+}
+
+// ===== Telemetria przebiegu =====
+//
+// Z --trace plik każde pokolenie dopisuje do pliku jeden wiersz JSON: najlepszy, średni
+// i najgorszy fitness, różnorodność (średni udział wolnych komórek różnych od najlepszego
+// osobnika), bieżącą mutację, liczbę restartów, pominięte oceny, zmutowane klony i zamiany
+// lokalnego przeszukiwania, a przy GA_PROFILE także liczbę alokacji i czasy faz w nanosekundach.
+// Bez --trace koszt to jedno porównanie wskaźnika na pokolenie.
+
+FILE *gaTraceFile = NULL;       // plik śladu; NULL = wyłączony
+int gaProgressInterval = 100;   // co ile pokoleń wypisywać postęp (0 = wcale)
+
+void traceGeneration(const GAContext *ga, int island) {
+    const Puzzle *pz = ga->puzzle;
+    const Population *pop = &ga->population;
+    const cell_t *best = ga->best->grid;
+    long sum = 0, differing = 0;
+    int worst = 0;
+    for (int i = 0; i < pop->size; i++) {
+        const Individual *ind = &pop->members[i];
+        sum += ind->fitness;
+        if (ind->fitness > worst) worst = ind->fitness;
+        for (int k = 0; k < pz->freeCount; k++) {
+            int cell = pz->freeCells[k];
+            differing += ind->grid[cell] != best[cell];
+        }
+    }
+    double diversity = pz->freeCount ? (double)differing / ((double)pop->size * pz->freeCount) : 0;
+    
+    // Cały wiersz jednym wywołaniem, żeby wątki wysp nie przeplatały zapisów
+    char line[512];
+    int length = snprintf(line, sizeof(line),
+                          "{\"island\":%d,\"generation\":%d,\"best\":%d,\"mean\":%.3f,\"worst\":%d,"
+                          "\"diversity\":%.4f,\"mutation_rate\":%.3f,\"restarts\":%d,\"saved_evals\":%ld,"
+                          "\"clones\":%ld,\"local_moves\":%ld",
+                          island, ga->generation, ga->best->fitness, (double)sum / pop->size, worst,
+                          diversity, ga->mutationRate, ga->restarts, ga->evaluationsSaved,
+                          ga->clonesMutated, ga->localSearchMoves);
+#if GA_PROFILE
+    // Licznik alokacji zwiększają także wątki innych wysp
+    length += snprintf(line + length, sizeof(line) - length, ",\"allocations\":%ld,\"phase_ns\":{",
+                       __atomic_load_n(&gaAllocations, __ATOMIC_RELAXED));
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        length += snprintf(line + length, sizeof(line) - length, "%s\"%s\":%llu", p ? "," : "",
+                           phaseNames[p], (unsigned long long)ga->times.nanos[p]);
+    }
+    length += snprintf(line + length, sizeof(line) - length, "}");
+#endif
+    snprintf(line + length, sizeof(line) - length, "}\n");
+    fputs(line, gaTraceFile);
+}
+
+// Podsumowanie czasów faz całego przebiegu (tylko przy GA_PROFILE)
+void printPhaseTimes(const PhaseTimes *times) {
+    uint64_t total = 0;
+    for (int p = 0; p < PHASE_COUNT; p++) total += times->nanos[p];
+    if (total == 0) return;
+    printf("Faza        czas [ms]   udział   wywołania\n");
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        printf("%-10s %10.2f %7.1f%% %11llu\n", phaseNames[p], times->nanos[p] / 1e6,
+               100.0 * times->nanos[p] / total, (unsigned long long)times->calls[p]);
+    }
+}
+
+// ===== Punkty kontrolne przebiegu =====
+//
+// Binarny obraz stanu GA na granicy pokoleń: nagłówek ze stałymi i przesunięciami sekcji,
+// potem wskazówki, maska stałych komórek, najlepsza plansza przebiegu, stany generatorów
+// wątków, fitness i skróty osobników oraz wszystkie plansze populacji jednym blokiem.
+// Sekcje są wyrównane do 8 bajtów, więc po mmap czyta się je bezpośrednio z pamięci.
+// Zapis robi osobny wątek: pętla GA tylko kopiuje stan do bufora, a gdy poprzedni zapis
+// jeszcze trwa, punkt kontrolny jest pomijany. Plik trafia na miejsce przez rename,
+// więc przerwanie w trakcie zapisu zostawia poprzedni, kompletny punkt kontrolny.
+// Liczności nie są zapisywane - po wczytaniu liczy się je od nowa (deterministycznie).
+
+#define CHECKPOINT_MAGIC "SGACKPT1"
+
+const char *gaCheckpointPath = NULL;   // plik punktów kontrolnych (--checkpoint)
+int gaCheckpointInterval = 500;         // co ile pokoleń zapisywać (--checkpoint-every)
+
+typedef struct {
+    char magic[8];
+    uint32_t headerSize;        // sizeof(CheckpointHeader) w chwili zapisu
+    int32_t n, populationSize, workerCount;
+    int32_t generation, bestIndex;
+    int32_t epochBest, lastImprovement, recordFitness, boosts, restarts;
+    int32_t blockOperators, dedup, stagnationLimit, selection[2], maxGenerations, localSearch;
+    int32_t tournamentSize, crossover;
+    int64_t evaluationsSaved, clonesMutated, localSearchMoves;
+    double mutationRate, baseMutationRate, localSearchShare, crossoverRate, elitismRate;
+    uint64_t givensOffset, fixedOffset, recordOffset, rngOffset;
+    uint64_t fitnessOffset, hashOffset, cellsOffset, size;
+} CheckpointHeader;
+
+typedef struct {
+    const char *path;
+    unsigned char *buffer;      // obraz pliku przygotowany przez pętlę GA
+    size_t size;
+    int pending;                // bufor czeka na zapis lub jest zapisywany
+    int stop;
+    long written, skipped;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_t thread;
+} Checkpointer;
+
+static inline uint64_t alignUp8(uint64_t offset) {
+    return (offset + 7) & ~(uint64_t)7;
+}
+
+// Przesunięcia sekcji i rozmiar pliku dla danej planszy, populacji i liczby wątków
+void checkpointLayout(CheckpointHeader *h, int n, int populationSize, int workerCount) {
+    uint64_t cells = (uint64_t)n * n;
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, CHECKPOINT_MAGIC, 8);
+    h->headerSize = sizeof(CheckpointHeader);
+    h->n = n;
+    h->populationSize = populationSize;
+    h->workerCount = workerCount;
+    h->givensOffset = alignUp8(sizeof(CheckpointHeader));
+    h->fixedOffset = alignUp8(h->givensOffset + cells * sizeof(cell_t));
+    h->recordOffset = alignUp8(h->fixedOffset + cells);
+    h->rngOffset = alignUp8(h->recordOffset + cells * sizeof(cell_t));
+    h->fitnessOffset = h->rngOffset + (uint64_t)workerCount * sizeof(Rng);
+    h->hashOffset = alignUp8(h->fitnessOffset + (uint64_t)populationSize * sizeof(int32_t));
+    h->cellsOffset = h->hashOffset + (uint64_t)populationSize * sizeof(uint64_t);
+    h->size = h->cellsOffset + (uint64_t)populationSize * cells * sizeof(cell_t);
+}
+
+// Zapisuje stan przebiegu do bufora w formacie pliku
+void checkpointSerialize(const GAContext *ga, unsigned char *buffer) {
+    const Puzzle *pz = ga->puzzle;
+    const Population *pop = &ga->population;
+    int cells = pz->n * pz->n;
+    CheckpointHeader h;
+    checkpointLayout(&h, pz->n, pop->size, ga->workerCount);
+    h.generation = ga->generation;
+    h.bestIndex = (int)(ga->best - pop->members);
+    h.epochBest = ga->epochBest;
+    h.lastImprovement = ga->lastImprovement;
+    h.recordFitness = ga->recordFitness;
+    h.boosts = ga->boosts;
+    h.restarts = ga->restarts;
+    h.blockOperators = pz->blockOperators;
+    h.dedup = ga->params.dedup;
+    h.stagnationLimit = ga->params.stagnationLimit;
+    h.selection[0] = (int)(ga->selection[0] - selectionStrategies);
+    h.selection[1] = (int)(ga->selection[1] - selectionStrategies);
+    h.maxGenerations = ga->params.maxGenerations;
+    h.localSearch = ga->params.localSearch;
+    h.tournamentSize = ga->selector.tournamentSize;
+    h.crossover = ga->params.crossover;
+    h.evaluationsSaved = ga->evaluationsSaved;
+    h.clonesMutated = ga->clonesMutated;
+    h.localSearchMoves = ga->localSearchMoves;
+    h.mutationRate = ga->mutationRate;
+    h.baseMutationRate = ga->params.mutationRate;
+    h.localSearchShare = ga->params.localSearchShare;
+    h.crossoverRate = ga->params.crossoverRate;
+    h.elitismRate = ga->params.elitismRate;
+    
+    memset(buffer, 0, h.cellsOffset);
+    memcpy(buffer, &h, sizeof(h));
+    memcpy(buffer + h.givensOffset, pz->givens, cells * sizeof(cell_t));
+    memcpy(buffer + h.fixedOffset, pz->fixed, cells);
+    memcpy(buffer + h.recordOffset, ga->record, cells * sizeof(cell_t));
+    for (int t = 0; t < ga->workerCount; t++) {
+        memcpy(buffer + h.rngOffset + t * sizeof(Rng), &ga->workers[t].rng, sizeof(Rng));
+    }
+    int32_t *fitness = (int32_t *)(buffer + h.fitnessOffset);
+    uint64_t *hashes = (uint64_t *)(buffer + h.hashOffset);
+    for (int i = 0; i < pop->size; i++) {
+        fitness[i] = pop->members[i].fitness;
+        hashes[i] = pop->members[i].hash;
+    }
+    // Plansze populacji leżą w arenie jednym blokiem
+    memcpy(buffer + h.cellsOffset, pop->cells, (size_t)pop->size * cells * sizeof(cell_t));
+}
+
+// Wątek zapisujący: plik tymczasowy, potem rename na docelową nazwę
+void *checkpointWriter(void *arg) {
+    Checkpointer *cp = arg;
+    char temp[4096];
+    snprintf(temp, sizeof(temp), "%s.tmp", cp->path);
+    pthread_mutex_lock(&cp->lock);
+    while (1) {
+        while (!cp->pending && !cp->stop) pthread_cond_wait(&cp->wake, &cp->lock);
+        if (!cp->pending) break;
+        pthread_mutex_unlock(&cp->lock);
+        
+        int ok = 0;
+        FILE *f = fopen(temp, "wb");
+        if (f) {
+            ok = fwrite(cp->buffer, 1, cp->size, f) == cp->size;
+            ok = fflush(f) == 0 && fsync(fileno(f)) == 0 && ok;
+            ok = fclose(f) == 0 && ok;
+        }
+        if (ok) ok = rename(temp, cp->path) == 0;
+        if (!ok) fprintf(stderr, "Błąd zapisu punktu kontrolnego: %s\n", cp->path);
+        
+        pthread_mutex_lock(&cp->lock);
+        if (ok) cp->written++;
+        cp->pending = 0;
+    }
+    pthread_mutex_unlock(&cp->lock);
+    return NULL;
+}
+
+void checkpointStart(Checkpointer *cp, const GAContext *ga, const char *path) {
+    CheckpointHeader h;
+    checkpointLayout(&h, ga->puzzle->n, ga->population.size, ga->workerCount);
+    cp->path = path;
+    cp->size = h.size;
+    cp->buffer = malloc(cp->size);
+    cp->pending = 0;
+    cp->stop = 0;
+    cp->written = 0;
+    cp->skipped = 0;
+    pthread_mutex_init(&cp->lock, NULL);
+    pthread_cond_init(&cp->wake, NULL);
+    pthread_create(&cp->thread, NULL, checkpointWriter, cp);
+}
+
+// Zleca zapis bieżącego stanu; gdy poprzedni zapis trwa, punkt jest pomijany
+void checkpointSave(Checkpointer *cp, const GAContext *ga) {
+    pthread_mutex_lock(&cp->lock);
+    int busy = cp->pending;
+    pthread_mutex_unlock(&cp->lock);
+    if (busy) {
+        cp->skipped++;
+        return;
+    }
+    checkpointSerialize(ga, cp->buffer);
+    pthread_mutex_lock(&cp->lock);
+    cp->pending = 1;
+    pthread_cond_signal(&cp->wake);
+    pthread_mutex_unlock(&cp->lock);
+}
+
+// Czeka na ostatni zapis i zatrzymuje wątek
+void checkpointStop(Checkpointer *cp) {
+    pthread_mutex_lock(&cp->lock);
+    cp->stop = 1;
+    pthread_cond_signal(&cp->wake);
+    pthread_mutex_unlock(&cp->lock);
+    pthread_join(cp->thread, NULL);
+    pthread_mutex_destroy(&cp->lock);
+    pthread_cond_destroy(&cp->wake);
+    free(cp->buffer);
+}
+
+// Odtwarza łamigłówkę i przebieg z punktu kontrolnego (mmap, bez parsowania).
+// Parametry wpływające na przebieg (operatory, dedup, stagnacja, selekcja, mutacja, lokalne
+// przeszukiwanie, limit pokoleń, liczba wątków) pochodzą z pliku; pozostałe z params.
+int checkpointLoad(const char *path, const SolverParams *params, Puzzle *pz, GAContext *ga) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(CheckpointHeader)) {
+        close(fd);
+        return 0;
+    }
+    const unsigned char *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return 0;
+    
+    CheckpointHeader h;
+    memcpy(&h, map, sizeof(h));
+    CheckpointHeader expected;
+    checkpointLayout(&expected, h.n, h.populationSize, h.workerCount);
+    int selectionCount = sizeof(selectionStrategies) / sizeof(selectionStrategies[0]);
+    int valid = memcmp(h.magic, CHECKPOINT_MAGIC, 8) == 0 && h.headerSize == sizeof(h) &&
+                h.n >= 1 && h.n <= MAX_N && h.populationSize >= 2 && h.workerCount >= 1 &&
+                h.size == expected.size && h.cellsOffset == expected.cellsOffset &&
+                h.size == (uint64_t)st.st_size && h.bestIndex >= 0 && h.bestIndex < h.populationSize &&
+                h.selection[0] >= 0 && h.selection[0] < selectionCount &&
+                h.selection[1] >= 0 && h.selection[1] < selectionCount &&
+                h.crossover >= SOLVER_CROSSOVER_MIXED && h.crossover <= SOLVER_CROSSOVER_BLOCK;
+    if (!valid || !puzzleInit(pz, h.n, map + h.givensOffset, map + h.fixedOffset)) {
+        munmap((void *)map, st.st_size);
+        return 0;
+    }
+    
+    SolverParams runParams = *params;
+    runParams.populationSize = h.populationSize;
+    runParams.threads = h.workerCount;
+    runParams.maxGenerations = h.maxGenerations;
+    runParams.mutationRate = h.baseMutationRate;
+    runParams.dedup = h.dedup;
+    runParams.stagnationLimit = h.stagnationLimit;
+    runParams.localSearch = h.localSearch;
+    runParams.localSearchShare = h.localSearchShare;
+    runParams.crossoverRate = h.crossoverRate;
+    runParams.elitismRate = h.elitismRate;
+    runParams.tournamentSize = h.tournamentSize;
+    runParams.crossover = h.crossover;
+    runParams.selection[0] = selectionStrategies[h.selection[0]].name;
+    runParams.selection[1] = selectionStrategies[h.selection[1]].name;
+    pz->blockOperators = h.blockOperators;
+    gaAllocate(ga, pz, &runParams);
+    gaResetState(ga, &runParams, 0);
+    
+    // Populacja bez losowania - plansze jednym kopiowaniem do areny;
+    // liczności odtwarzane i sprawdzane z zapisanym fitness
+    int cells = h.n * h.n;
+    Population *pop = &ga->population;
+    const int32_t *fitness = (const int32_t *)(map + h.fitnessOffset);
+    const uint64_t *hashes = (const uint64_t *)(map + h.hashOffset);
+    memcpy(pop->cells, map + h.cellsOffset, (size_t)pop->size * cells * sizeof(cell_t));
+    for (int i = 0; i < pop->size; i++) {
+        recountIndividual(pz, &pop->members[i]);
+        pop->members[i].hash = hashes[i];
+        if (pop->members[i].fitness != fitness[i]) valid = 0;
+    }
+    for (int t = 0; t < ga->workerCount; t++) {
+        memcpy(&ga->workers[t].rng, map + h.rngOffset + t * sizeof(Rng), sizeof(Rng));
+    }
+    memcpy(ga->record, map + h.recordOffset, cells * sizeof(cell_t));
+    ga->generation = h.generation;
+    ga->best = &pop->members[h.bestIndex];
+    ga->epochBest = h.epochBest;
+    ga->lastImprovement = h.lastImprovement;
+    ga->recordFitness = h.recordFitness;
+    ga->boosts = h.boosts;
+    ga->restarts = h.restarts;
+    ga->evaluationsSaved = h.evaluationsSaved;
+    ga->clonesMutated = h.clonesMutated;
+    ga->localSearchMoves = h.localSearchMoves;
+    setMutationRate(ga, h.mutationRate);
+    munmap((void *)map, st.st_size);
+    
+    if (!valid) {
+        gaFree(ga);
+        puzzleFree(pz);
+    }
+    return valid;
+}
+
+// ===== Model wyspowy =====
+//
+// K niezależnych subpopulacji, każda rozwijana przez własny wątek tymi samymi
+// operatorami. Co params.migrationInterval pokoleń wyspy wymieniają najlepsze osobniki
+// (pierścień lub losowe połączenia); migrant zastępuje najgorszego osobnika wyspy docelowej.
+
+// Domyślne ustawienia wysp (z linii poleceń, przez solverDefaultParams)
+int gaIslands = 1;              // liczba wysp (1 = jedna populacja)
+int gaIslandSize = 0;           // rozmiar wyspy; 0 = populationSize z parametrów / liczba wysp
+int gaMigrationInterval = 50;   // co ile pokoleń następuje migracja
+int gaRandomTopology = 0;       // 0 = pierścień, 1 = losowe połączenia
+
+typedef struct {
+    GAContext *islands;
+    int count;
+    Rng migrationRng;           // wybór celów przy topologii losowej
+    int randomTopology;
+    int solved;                 // któraś wyspa znalazła rozwiązanie
+    int verbose;
+    pthread_barrier_t epoch;    // synchronizacja przed i po migracji
+    pthread_t *threads;
+} Archipelago;
+
+typedef struct {
+    Archipelago *archipelago;
+    int index;
+} IslandThread;
+
+// Przenosi najlepszego osobnika każdej wyspy do wyspy docelowej
+void migrate(Archipelago *arch) {
+    // Najpierw kopie migrantów (bufor roboczy wyspy), aby wymiana nie zależała od kolejności
+    for (int k = 0; k < arch->count; k++) {
+        GAContext *ga = &arch->islands[k];
+        copyIndividual(ga->puzzle, ga->best, &ga->newPopulation.members[ga->newPopulation.size]);
+    }
+    
+    for (int k = 0; k < arch->count; k++) {
+        int target = (k + 1) % arch->count;
+        if (arch->randomTopology) {
+            target = (k + 1 + rngInt(&arch->migrationRng, arch->count - 1)) % arch->count;
+        }
+        GAContext *source = &arch->islands[k];
+        GAContext *dest = &arch->islands[target];
+        Individual *migrant = &source->newPopulation.members[source->newPopulation.size];
+        
+        // Najgorszy osobnik wyspy docelowej (z pominięciem jej najlepszego)
+        Individual *worst = NULL;
+        for (int i = 0; i < dest->population.size; i++) {
+            Individual *ind = &dest->population.members[i];
+            if (ind != dest->best && (!worst || ind->fitness > worst->fitness)) worst = ind;
+        }
+        if (worst && migrant->fitness < worst->fitness) {
+            copyIndividual(dest->puzzle, migrant, worst);
+            if (worst->fitness < dest->best->fitness) dest->best = worst;
+        }
+    }
+}
+
+// Wątek wyspy: epoki po params.migrationInterval pokoleń przeplatane migracją
+void *islandWorker(void *arg) {
+    IslandThread *self = arg;
+    Archipelago *arch = self->archipelago;
+    GAContext *ga = &arch->islands[self->index];
+    
+    while (1) {
+        int epochStart = ga->generation;
+        for (int g = 0; g < ga->params.migrationInterval && ga->generation < ga->params.maxGenerations; g++) {
+            gaGeneration(ga);
+            if (gaTraceFile) traceGeneration(ga, self->index);
+            if (ga->best->fitness == 0) break;
+        }
+        
+        // Wszystkie wyspy kończą epokę; wątek 0 sprawdza wynik i wykonuje migrację
+        pthread_barrier_wait(&arch->epoch);
+        if (self->index == 0) {
+            for (int k = 0; k < arch->count; k++) {
+                if (arch->islands[k].best->fitness == 0) arch->solved = 1;
+            }
+            if (!arch->solved && ga->generation < ga->params.maxGenerations) {
+                migrate(arch);
+            }
+            // Postęp jak w jednej populacji: gdy epoka objęła pokolenie podzielne przez interwał
+            int interval = gaProgressInterval;
+            int reported = interval > 0 && (epochStart + interval - 1) / interval * interval < ga->generation;
+            if (arch->verbose && reported) {
+                int best = arch->islands[0].best->fitness;
+                for (int k = 1; k < arch->count; k++) {
+                    if (arch->islands[k].best->fitness < best) best = arch->islands[k].best->fitness;
+                }
+                printf("Pokolenie %d: Najlepszy fitness = %d\n", ga->generation, best);
+            }
+        }
+        pthread_barrier_wait(&arch->epoch);
+        if (arch->solved || ga->generation >= ga->params.maxGenerations) break;
+    }
+    return NULL;
+}
+
+// Model wyspowy; najlepsze rozwiązanie ze wszystkich wysp trafia do result->grid.
+// Każda wyspa dostaje parametry przebiegu z własnym rozmiarem populacji i jednym wątkiem.
+void runIslandModel(const Puzzle *pz, const SolverParams *params, GAResult *result) {
+    Archipelago arch;
+    uint64_t seed = params->seed;
+    int verbose = params->verbose;
+    double startTime = nowSeconds();
+    int islands = params->islands < 1 ? 1 : params->islands;
+    SolverParams islandParams = *params;
+    islandParams.populationSize = params->islandSize > 0 ? params->islandSize : params->populationSize / islands;
+    islandParams.threads = 1;
+    if (islandParams.migrationInterval < 1) islandParams.migrationInterval = 1;
+    Puzzle view = solverPuzzleView(pz, params);
+    
+    arch.count = islands;
+    arch.randomTopology = params->randomTopology;
+    arch.solved = 0;
+    arch.verbose = verbose;
+    arch.islands = malloc(arch.count * sizeof(GAContext));
+    arch.threads = malloc(arch.count * sizeof(pthread_t));
+    IslandThread *args = malloc(arch.count * sizeof(IslandThread));
+    rngSeed(&arch.migrationRng, seed, UINT32_MAX - 1);
+    
+    // Każda wyspa ma jeden wątek i własny strumień losowy
+    for (int k = 0; k < arch.count; k++) {
+        gaInit(&arch.islands[k], &view, &islandParams, k);
+    }
+    if (verbose) {
+        int best = arch.islands[0].best->fitness;
+        for (int k = 1; k < arch.count; k++) {
+            if (arch.islands[k].best->fitness < best) best = arch.islands[k].best->fitness;
+        }
+        printf("Początkowa liczba konfliktów: %d\n", best);
+    }
+    
+    pthread_barrier_init(&arch.epoch, NULL, arch.count);
+    for (int k = 0; k < arch.count; k++) {
+        args[k].archipelago = &arch;
+        args[k].index = k;
+        if (k > 0) pthread_create(&arch.threads[k], NULL, islandWorker, &args[k]);
+    }
+    islandWorker(&args[0]);
+    for (int k = 1; k < arch.count; k++) {
+        pthread_join(arch.threads[k], NULL);
+    }
+    pthread_barrier_destroy(&arch.epoch);
+    
+    GAContext *winner = &arch.islands[0];
+    for (int k = 1; k < arch.count; k++) {
+        if (arch.islands[k].recordFitness < winner->recordFitness) winner = &arch.islands[k];
+    }
+    if (verbose && winner->recordFitness == 0) {
+        printf("Znaleziono rozwiązanie w pokoleniu %d (wyspa %d)\n", winner->generation - 1, (int)(winner - arch.islands));
+    }
+    
+    memcpy(result->grid, winner->record, pz->n * pz->n * sizeof(cell_t));
+    result->fitness = winner->recordFitness;
+    result->generations = winner->generation;
+    result->evaluations = 0;
+    result->evaluationsSaved = 0;
+    long clones = 0;
+    PhaseTimes times = {{0}, {0}};
+    for (int k = 0; k < arch.count; k++) {
+        result->evaluations += (long)(arch.islands[k].generation + 1) * arch.islands[k].population.size;
+        result->evaluationsSaved += arch.islands[k].evaluationsSaved;
+        clones += arch.islands[k].clonesMutated;
+        addPhaseTimes(&times, &arch.islands[k].totalTimes);
+    }
+    if (verbose) {
+        printf("Pominięte oceny duplikatów: %ld z %ld, zmutowane klony: %ld\n",
+               result->evaluationsSaved, result->evaluations, clones);
+        printPhaseTimes(&times);
+    }
+    result->seconds = nowSeconds() - startTime;
+    
+    for (int k = 0; k < arch.count; k++) {
+        gaFree(&arch.islands[k]);
+    }
+    free(arch.islands);
+    free(arch.threads);
+    free(args);
+}
+
+// ===== Symulowane wyżarzanie =====
+//
+// Alternatywa dla GA: jedno rozwiązanie wypełnione zgodnie z blokami, które zmienia się
+// przez zamiany dwóch wolnych komórek w bloku. Bloki są zawsze poprawne, więc koszt to
+// konflikty w wierszach i kolumnach, liczone przyrostowo z tablic liczności.
+// Temperatura spada geometrycznie co łańcuch ruchów; gdy najlepszy wynik długo się
+// nie poprawia, następuje ponowne podgrzanie do temperatury początkowej.
+
+// Domyślny silnik i harmonogram wyżarzania (z linii poleceń, przez solverDefaultParams)
+int useAnnealing = 0;           // 0 = algorytm genetyczny, 1 = symulowane wyżarzanie
+double saInitialTemp = 0;       // temperatura początkowa; 0 = odchylenie kosztu sąsiadów
+double saCooling = 0.99;        // mnożnik temperatury po każdym łańcuchu
+int saChainLength = 0;          // ruchy na jednej temperaturze; 0 = suma kwadratów wolnych komórek bloków
+int saReheatAfter = 40;         // łańcuchy bez poprawy najlepszego wyniku przed podgrzaniem
+long saMaxSteps = 20000000;     // limit ruchów
+
+// Losuje zamianę dwóch różnych wolnych komórek tego samego bloku.
+// Zwraca 0, gdy żaden blok nie ma dwóch wolnych komórek.
+int generate_neighbor(const Puzzle *pz, Rng *rng, int *first, int *second) {
+    if (pz->freeCount < 2) return 0;
+    for (int attempts = 0; attempts < 100; attempts++) {
+        int cell = pz->freeCells[rngInt(rng, pz->freeCount)];
+        int block = pz->blockOf[cell];
+        int start = pz->blockStart[block];
+        int count = pz->blockStart[block + 1] - start;
+        if (count < 2) continue;
+        
+        // Partner spośród pozostałych wolnych komórek bloku
+        int other = pz->blockFree[start + rngInt(rng, count - 1)];
+        if (other == cell) other = pz->blockFree[start + count - 1];
+        *first = cell;
+        *second = other;
+        return 1;
+    }
+    return 0;
+}
+
+void runAnnealing(const Puzzle *pz, const SolverParams *params, GAResult *result) {
+    int n = pz->n;
+    int verbose = params->verbose;
+    double startTime = nowSeconds();
+    Rng rng;
+    rngSeed(&rng, params->seed, 0);
+    
+    Individual current;
+    current.grid = malloc(n * n * sizeof(cell_t));
+    current.counts = malloc(COUNTS_SIZE(n) * sizeof(cell_t));
+    initialize_solution_randomly(pz, &current, &rng);
+    memcpy(result->grid, current.grid, n * n * sizeof(cell_t));
+    result->fitness = current.fitness;
+    if (verbose) printf("Początkowa liczba konfliktów: %d\n", current.fitness);
+    
+    long steps = 0;
+    int first, second;
+    int movable = generate_neighbor(pz, &rng, &first, &second);
+    
+    // Temperatura początkowa: odchylenie standardowe kosztu po serii losowych ruchów
+    double temperature = params->annealingTemp;
+    if (movable && temperature <= 0) {
+        double sum = 0, sumSquares = 0;
+        const int samples = 200;
+        for (int k = 0; k < samples; k++) {
+            generate_neighbor(pz, &rng, &first, &second);
+            swapCells(pz, &current, first, second);
+            sum += current.fitness;
+            sumSquares += (double)current.fitness * current.fitness;
+        }
+        steps += samples;
+        double mean = sum / samples;
+        temperature = sqrt(fmax(sumSquares / samples - mean * mean, 0.0));
+        if (temperature <= 0) temperature = 1.0;
+        if (current.fitness < result->fitness) {
+            memcpy(result->grid, current.grid, n * n * sizeof(cell_t));
+            result->fitness = current.fitness;
+        }
+    }
+    double initialTemp = temperature;
+    double cooling = params->annealingCooling > 0 && params->annealingCooling < 1 ? params->annealingCooling : 0.99;
+    int reheatAfter = params->annealingReheat < 1 ? 1 : params->annealingReheat;
+    
+    int chainLength = params->annealingChain;
+    if (chainLength <= 0) {
+        for (int b = 0; b < n; b++) {
+            int count = pz->blockStart[b + 1] - pz->blockStart[b];
+            chainLength += count * count;
+        }
+        if (chainLength < 1) chainLength = 1;
+    }
+    
+    // Postęp mierzony jest najlepszym kosztem od ostatniego podgrzania
+    int stale = 0, chain = 0, reheats = 0;
+    int phaseBest = current.fitness;
+    while (movable && result->fitness > 0 && steps < params->annealingSteps) {
+        int improved = 0;
+        for (int k = 0; k < chainLength && current.fitness > 0; k++) {
+            generate_neighbor(pz, &rng, &first, &second);
+            int delta = swapDelta(pz, &current, first, second);
+            steps++;
+            if (delta <= 0 || rngDouble(&rng) < exp(-delta / temperature)) {
+                swapCells(pz, &current, first, second);
+                if (current.fitness < phaseBest) {
+                    phaseBest = current.fitness;
+                    improved = 1;
+                    if (current.fitness < result->fitness) {
+                        memcpy(result->grid, current.grid, n * n * sizeof(cell_t));
+                        result->fitness = current.fitness;
+                    }
+                }
+            }
+        }
+        
+        temperature *= cooling;
+        stale = improved ? 0 : stale + 1;
+        if (stale >= reheatAfter) {
+            temperature = initialTemp;
+            phaseBest = INT32_MAX;
+            stale = 0;
+            reheats++;
+        }
+        if (verbose && ++chain % 100 == 0) {
+            printf("Łańcuch %d: T = %.4f, konflikty = %d, najlepszy = %d, podgrzania = %d\n",
+                   chain, temperature, current.fitness, result->fitness, reheats);
+        }
+    }
+    if (verbose && result->fitness == 0) printf("Znaleziono rozwiązanie po %ld ruchach\n", steps);
+    
+    result->generations = (int)(steps < INT32_MAX ? steps : INT32_MAX);
+    result->evaluations = steps + 1;
+    result->evaluationsSaved = 0;
+    result->seconds = nowSeconds() - startTime;
+    free(current.grid);
+    free(current.counts);
+}
+
+// ===== API biblioteki solvera =====
+//
+// Implementacja sudoku_solver.h. Kontekst trzyma własną łamigłówkę, kopię parametrów
+// i stan GA; globalne zmienne programu służą wyłącznie za wartości domyślne
+// (solverDefaultParams), więc równoległe rozwiązywania nie współdzielą stanu.
+// Tryby wsadowe korzystają z tej samej pętli przez runSinglePopulation.
+
+struct SudokuSolver {
+    Puzzle puzzle;              // własna łamigłówka (solverInit, --resume)
+    int ownsPuzzle;
+    const Puzzle *pz;           // łamigłówka, na której pracuje solver
+    SolverParams params;
+    GAContext ga;
+    int gaAllocated;            // kontekst GA istnieje (areny i wątki, do ponownego użycia)
+    int gaActive;               // bieżące rozwiązywanie to krokowy przebieg GA
+    int status;                 // SOLVER_*
+    GAResult result;            // wynik presolve albo silnika całościowego (wyspy, wyżarzanie)
+    int presolvedCells;
+    SolverProgressCallback callback;
+    void *userData;
+    int interval;
+    Checkpointer checkpointer;
+    int checkpointing;
+    double startTime, seconds;
+};
+
+void solverDefaultParams(SolverParams *params) {
+    memset(params, 0, sizeof(*params));
+    params->seed = gaSeed;
+    params->engine = useAnnealing ? SOLVER_ENGINE_ANNEALING : gaIslands > 1 ? SOLVER_ENGINE_ISLANDS : SOLVER_ENGINE_GA;
+    params->populationSize = gaPopulationSize;
+    params->maxGenerations = gaGenerations;
+    params->threads = gaThreads;
+    params->mutationRate = gaMutationRate;
+    params->crossoverRate = gaCrossoverRate;
+    params->elitismRate = gaElitismRate;
+    params->tournamentSize = gaTournamentSize;
+    params->crossover = gaCrossover;
+    params->selection[0] = parentSelection[0]->name;
+    params->selection[1] = parentSelection[1]->name;
+    params->presolve = gaPresolve;
+    params->blockOperators = gaBlockOperators;
+    params->dedup = gaDedup;
+    params->stagnationLimit = gaStagnationLimit;
+    params->localSearch = gaLocalSearch;
+    params->localSearchShare = gaLocalSearchShare;
+    params->islands = gaIslands;
+    params->islandSize = gaIslandSize;
+    params->migrationInterval = gaMigrationInterval;
+    params->randomTopology = gaRandomTopology;
+    params->annealingTemp = saInitialTemp;
+    params->annealingCooling = saCooling;
+    params->annealingChain = saChainLength;
+    params->annealingReheat = saReheatAfter;
+    params->annealingSteps = saMaxSteps;
+    params->checkpointPath = gaCheckpointPath;
+    params->checkpointInterval = gaCheckpointInterval;
+}
+
+// Funkcja postępu trybu interaktywnego i --resume
+static int printProgress(const SolverProgress *progress, void *userData) {
+    (void)userData;
+    printf("Pokolenie %d: Najlepszy fitness = %d\n", progress->generation, progress->bestFitness);
+    return 0;
+}
+
+// Wspólny start po przygotowaniu kontekstu GA (nowego albo z punktu kontrolnego)
+static void solverAttach(SudokuSolver *s) {
+    s->status = SOLVER_RUNNING;
+    s->startTime = nowSeconds();
+    s->checkpointing = s->gaActive && s->params.checkpointPath && s->params.checkpointInterval > 0;
+    if (s->checkpointing) checkpointStart(&s->checkpointer, &s->ga, s->params.checkpointPath);
+}
+
+// Solver na istniejącej łamigłówce (bez presolve; s wyzerowane); krokowo działa tylko GA
+static void solverStart(SudokuSolver *s, const Puzzle *pz, const SolverParams *params) {
+    s->puzzle = solverPuzzleView(pz, params);
+    s->pz = &s->puzzle;
+    s->params = *params;
+    if (params->engine == SOLVER_ENGINE_GA) {
+        gaInit(&s->ga, s->pz, params, 0);
+        s->gaAllocated = 1;
+        s->gaActive = 1;
+    }
+    solverAttach(s);
+}
+
+// Koniec przebiegu: zapis punktów kontrolnych i podsumowanie
+static void solverFinish(SudokuSolver *s) {
+    s->seconds = nowSeconds() - s->startTime;
+    if (s->checkpointing) {
+        checkpointStop(&s->checkpointer);
+        s->checkpointing = 0;
+        if (s->params.verbose) {
+            printf("Punkty kontrolne: zapisane %ld, pominięte %ld (%s)\n",
+                   s->checkpointer.written, s->checkpointer.skipped, s->params.checkpointPath);
+        }
+    }
+    if (s->gaActive && s->params.verbose) {
+        printf("Pominięte oceny duplikatów: %ld z %ld, zmutowane klony: %ld\n", s->ga.evaluationsSaved,
+               (long)(s->ga.generation + 1) * s->ga.population.size, s->ga.clonesMutated);
+        if (s->params.localSearch > 0) printf("Zamiany lokalnego przeszukiwania: %ld\n", s->ga.localSearchMoves);
+        printPhaseTimes(&s->ga.totalTimes);
+    }
+}
+
+int solverStep(SudokuSolver *s, int generations) {
+    if (s->status != SOLVER_RUNNING) return s->status;
+    
+    // Wyspy i wyżarzanie nie mają kroków - cały przebieg przy pierwszym wywołaniu
+    if (!s->gaActive) {
+        if (s->params.engine == SOLVER_ENGINE_ANNEALING) {
+            runAnnealing(s->pz, &s->params, &s->result);
+        } else {
+            runIslandModel(s->pz, &s->params, &s->result);
+        }
+        s->status = s->result.fitness == 0 ? SOLVER_SOLVED : SOLVER_EXHAUSTED;
+        solverFinish(s);
+        return s->status;
+    }
+    
+    GAContext *ga = &s->ga;
+    for (int g = 0; g < generations && s->status == SOLVER_RUNNING; g++) {
+        if (ga->generation >= s->params.maxGenerations) {
+            s->status = SOLVER_EXHAUSTED;
+            break;
+        }
+        gaGeneration(ga);
+        int generation = ga->generation - 1;
+        if (gaTraceFile) traceGeneration(ga, 0);
+        
+        int stop = 0;
+        if (s->callback && generation % s->interval == 0) {
+            SolverProgress progress = { generation, ga->best->fitness, ga->recordFitness, ga->restarts,
+                                        ga->mutationRate, nowSeconds() - s->startTime };
+            stop = s->callback(&progress, s->userData);
+        }
+        
+        if (ga->best->fitness == 0) {
+            if (s->params.verbose) printf("Znaleziono rozwiązanie w pokoleniu %d\n", generation);
+            s->status = SOLVER_SOLVED;
+        } else if (ga->generation >= s->params.maxGenerations) {
+            s->status = SOLVER_EXHAUSTED;
+        } else if (stop) {
+            s->status = SOLVER_STOPPED;
+        }
+        if (s->checkpointing && s->status != SOLVER_SOLVED && ga->generation % s->params.checkpointInterval == 0) {
+            checkpointSave(&s->checkpointer, ga);
+        }
+    }
+    if (s->status != SOLVER_RUNNING) solverFinish(s);
+    return s->status;
+}
+
+int solverRun(SudokuSolver *s) {
+    while (solverStep(s, INT32_MAX) == SOLVER_RUNNING) {}
+    return s->status;
+}
+
+void solverSetProgress(SudokuSolver *s, SolverProgressCallback callback, void *userData, int interval) {
+    s->callback = callback;
+    s->userData = userData;
+    s->interval = interval > 0 ? interval : 1;
+}
+
+// Wynik w postaci wewnętrznej (najlepsza plansza całego przebiegu)
+static void solverCollect(const SudokuSolver *s, GAResult *result) {
+    if (s->gaActive) {
+        const GAContext *ga = &s->ga;
+        memcpy(result->grid, ga->record, s->pz->n * s->pz->n * sizeof(cell_t));
+        result->fitness = ga->recordFitness;
+        result->generations = ga->generation;
+        result->evaluations = (long)(ga->generation + 1) * ga->population.size;
+        result->evaluationsSaved = ga->evaluationsSaved;
+    } else {
+        *result = s->result;
+    }
+    result->seconds = s->status == SOLVER_RUNNING ? nowSeconds() - s->startTime : s->seconds;
+}
+
+int solverResult(const SudokuSolver *s, unsigned char *grid, SolverStats *stats) {
+    GAResult result;
+    solverCollect(s, &result);
+    if (grid) memcpy(grid, result.grid, s->pz->n * s->pz->n * sizeof(cell_t));
+    if (stats) {
+        stats->fitness = result.fitness;
+        stats->generations = result.generations;
+        stats->evaluations = result.evaluations;
+        stats->evaluationsSaved = result.evaluationsSaved;
+        stats->presolvedCells = s->presolvedCells;
+        stats->restarts = s->gaActive ? s->ga.restarts : 0;
+        stats->localSearchMoves = s->gaActive ? s->ga.localSearchMoves : 0;
+        stats->seconds = result.seconds;
+    }
+    return result.fitness;
+}
+
+// Zwalnia zasoby kontekstu bez samej struktury (także dla kontekstów na stosie)
+static void solverRelease(SudokuSolver *s) {
+    if (s->checkpointing) checkpointStop(&s->checkpointer);
+    if (s->gaAllocated) gaFree(&s->ga);
+    if (s->ownsPuzzle) puzzleFree(&s->puzzle);
+}
+
+void solverDestroy(SudokuSolver *s) {
+    if (!s) return;
+    solverRelease(s);
+    free(s);
+}
+
+// Wczytuje łamigłówkę do kontekstu (nowego albo używanego wcześniej) i rozpoczyna
+// rozwiązywanie. Łamigłówka tego samego rozmiaru jest wczytywana w miejsce poprzedniej,
+// a kontekst GA przy tej samej populacji i liczbie wątków zaczyna od nowa bez alokacji.
+// Zwraca 0 przy błędnych danych - kontekst pozostaje wtedy bez zmian
+static int solverLoad(SudokuSolver *s, int n, const unsigned char *cells, const SolverParams *params) {
+    int srn = (int)sqrt(n);
+    while (srn * srn < n) srn++;
+    if (n < 1 || n > MAX_N || srn * srn != n || !cells) return 0;
+    SolverParams defaults;
+    if (!params) {
+        solverDefaultParams(&defaults);
+        params = &defaults;
+    }
+    
+    cell_t grid[MAX_N * MAX_N];
+    unsigned char fixedCells[MAX_N * MAX_N];
+    for (int k = 0; k < n * n; k++) {
+        if (cells[k] > n) return 0;
+        grid[k] = cells[k];
+        fixedCells[k] = cells[k] != 0;
+    }
+    
+    // Komórki wymuszone logiką stają się stałymi; przy sprzeczności plansza zostaje bez zmian
+    PresolveStats stats = { 0 };
+    int solved = 0;
+    if (params->presolve) {
+        cell_t presolved[MAX_N * MAX_N];
+        unsigned char presolvedFixed[MAX_N * MAX_N];
+        memcpy(presolved, grid, n * n * sizeof(cell_t));
+        memcpy(presolvedFixed, fixedCells, n * n);
+        solved = presolve(n, presolved, presolvedFixed, &stats);
+        if (!stats.contradiction) {
+            memcpy(grid, presolved, n * n * sizeof(cell_t));
+            memcpy(fixedCells, presolvedFixed, n * n);
+        }
+    }
+    
+    // Koniec poprzedniego rozwiązywania; areny GA zostają, jeśli pasują do nowego
+    if (s->checkpointing) {
+        checkpointStop(&s->checkpointer);
+        s->checkpointing = 0;
+    }
+    int samePuzzle = s->ownsPuzzle && s->puzzle.n == n;
+    int populationSize = params->populationSize < 2 ? 2 : params->populationSize;
+    int threads = params->threads < 1 ? 1 : params->threads;
+    int reusable = samePuzzle && s->ga.population.size == populationSize && s->ga.workerCount == threads &&
+                   s->ga.eliteCount == eliteCountFor(populationSize, params->elitismRate);
+    if (s->gaAllocated && !reusable) {
+        gaFree(&s->ga);
+        s->gaAllocated = 0;
+    }
+    if (samePuzzle) {
+        puzzleLoad(&s->puzzle, grid, fixedCells);
+    } else {
+        if (s->ownsPuzzle) puzzleFree(&s->puzzle);
+        puzzleInit(&s->puzzle, n, grid, fixedCells);
+        s->ownsPuzzle = 1;
+    }
+    s->puzzle.blockOperators = params->blockOperators;
+    s->pz = &s->puzzle;
+    s->params = *params;
+    s->gaActive = 0;
+    s->seconds = 0;
+    memset(&s->result, 0, sizeof(s->result));
+    s->presolvedCells = stats.contradiction ? 0 : stats.filled;
+    
+    if (solved && !stats.contradiction) {
+        // Presolve wystarczył - GA nie jest potrzebny
+        s->status = SOLVER_SOLVED;
+        memcpy(s->result.grid, grid, n * n * sizeof(cell_t));
+        return 1;
+    }
+    if (params->engine == SOLVER_ENGINE_GA) {
+        if (s->gaAllocated) {
+            gaReset(&s->ga, params, 0);
+        } else {
+            gaInit(&s->ga, &s->puzzle, params, 0);
+            s->gaAllocated = 1;
+        }
+        s->gaActive = 1;
+    }
+    solverAttach(s);
+    return 1;
+}
+
+SudokuSolver *solverInit(int n, const unsigned char *cells, const SolverParams *params) {
+    SudokuSolver *s = calloc(1, sizeof(SudokuSolver));
+    if (s && !solverLoad(s, n, cells, params)) {
+        free(s);
+        return NULL;
+    }
+    return s;
+}
+
+int solverReset(SudokuSolver *s, int n, const unsigned char *cells, const SolverParams *params) {
+    return solverLoad(s, n, cells, params);
+}
+
+// Jedna populacja przez ten sam kontekst co API; najlepsze rozwiązanie trafia do result->grid
+void runSinglePopulation(const Puzzle *pz, const SolverParams *params, GAResult *result) {
+    SudokuSolver solver = { 0 };
+    SolverParams singleParams = *params;
+    singleParams.engine = SOLVER_ENGINE_GA;
+    solverStart(&solver, pz, &singleParams);
+    if (params->verbose) printf("Początkowa liczba konfliktów: %d\n", solver.ga.best->fitness);
+    if (params->verbose && gaProgressInterval > 0) solverSetProgress(&solver, printProgress, NULL, gaProgressInterval);
+    solverRun(&solver);
+    solverCollect(&solver, result);
+    solverRelease(&solver);
+}
+
+// Rozwiązuje łamigłówkę silnikiem wybranym w params (wyżarzanie, jedna populacja lub wyspy)
+void solvePuzzle(const Puzzle *pz, const SolverParams *params, GAResult *result) {
+    if (params->engine == SOLVER_ENGINE_ANNEALING) {
+        runAnnealing(pz, params, result);
+    } else if (params->engine == SOLVER_ENGINE_ISLANDS) {
+        runIslandModel(pz, params, result);
+    } else {
+        runSinglePopulation(pz, params, result);
+    }
+}
+
+// Parametry domyślne z własnym ziarnem - dla trybów wsadowych i porównań
+SolverParams paramsWithSeed(uint64_t seed) {
+    SolverParams params;
+    solverDefaultParams(&params);
+    params.seed = seed;
+    params.checkpointPath = NULL;   // punkty kontrolne tylko w grze interaktywnej i --resume
+    return params;
+}
+
+// Algorytm genetyczny do rozwiązania Sudoku - klient API: plansza gry zamieniana jest
+// na wskazówki (tylko stałe komórki), a najlepsze rozwiązanie wraca na planszę
+void solveSudokuGA() {
+    SolverParams params;
+    solverDefaultParams(&params);
+    params.seed = gaSeedSet ? gaSeed : rngNext(&gameRng);
+    params.verbose = 1;
+    if (params.engine == SOLVER_ENGINE_ANNEALING) {
+        printf("Ziarno: %llu, silnik: wyżarzanie\n", (unsigned long long)params.seed);
+    } else {
+        printf("Ziarno: %llu, wątki: %d, wyspy: %d\n", (unsigned long long)params.seed, params.threads, params.islands);
+    }
+    
+    cell_t cells[MAX_N * MAX_N];
+    int blanks = 0;
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            cells[i * N + j] = fixed[i][j] ? board[i][j] : 0;
+            blanks += cells[i * N + j] == 0;
+        }
+    }
+    
+    SolverStats stats;
+    SudokuSolver *solver = solverInit(N, cells, &params);
+    if (!solver) {
+        printf("Nieprawidłowa plansza.\n");
+        return;
+    }
+    solverResult(solver, NULL, &stats);
+    if (params.presolve) printf("Presolve: wypełniono %d z %d pustych komórek\n", stats.presolvedCells, blanks);
+    if (params.engine == SOLVER_ENGINE_GA && stats.presolvedCells < blanks) {
+        printf("Początkowa liczba konfliktów: %d\n", stats.fitness);
+    }
+    if (gaProgressInterval > 0) solverSetProgress(solver, printProgress, NULL, gaProgressInterval);
+    solverRun(solver);
+    solverResult(solver, cells, &stats);
+    solverDestroy(solver);
+    
+    // Skopiuj najlepsze rozwiązanie do planszy
+    storeCells(cells, board);
+    
+    // Wyświetl wynik
+    if (stats.presolvedCells == blanks) {
+        printf("\nSudoku rozwiązane przez propagację ograniczeń\n");
+    } else {
+        printf("\nSudoku rozwiązane przez %s (konflikty: %d)\n",
+               params.engine == SOLVER_ENGINE_ANNEALING ? "wyżarzanie" : "GA", stats.fitness);
+    }
+}
+
+// Usuwa komórki z planszy, aby stworzyć zagadkę sudoku z określoną liczbą wskazówek.
+// Zostaje tylko łamigłówka z jednym rozwiązaniem, więc przy trudnych poziomach
+// wskazówek może być więcej niż clues.
+void removeCells(int clues) {
+    cell_t cells[MAX_N * MAX_N];
+    loadCells(board, cells);
+    carvePuzzle(N, cells, clues, &gameRng);
+    storeCells(cells, board);
+    for (int i = 0; i < N; i++)
+        for (int j = 0; j < N; j++)
+            fixed[i][j] = board[i][j] != 0;
+}
+
+// Wyświetla aktualny stan planszy
 
 void printBoard() {
     printf("\n");
-    for (int i = 0; i < N; i++) {
-        if (i % SRN == 0 && i != 0)
-            for (int k = 0; k < N * 3; k++) printf("-");
-        printf("\n");
-        for (int j = 0; j < N; j++) {
-            if (j % SRN == 0 && j != 0)
-                printf(" | ");
-            if (board[i][j] == 0)
-                printf(" . ");
-            else
-                printf("%2d ", board[i][j]);
+    for (int i = 0; i < N; i++) {
+        if (i % SRN == 0 && i != 0)
+            for (int k = 0; k < N * 3 + (SRN - 1) * 3; k++) printf("-");
+        printf("\n");
+        for (int j = 0; j < N; j++) {
+            if (j % SRN == 0 && j != 0)
+                printf(" | ");
+            if (board[i][j] == 0)
+                printf(" . ");
+            else
+                printf("%2d ", board[i][j]);
+        }
+        printf("\n");
+    }
+}
+
+// Zapisuje stan gry do pliku
+
+void saveGame() {
+    FILE *f = fopen("save.txt", "w");
+    if (!f) {
+        printf("Błąd zapisu\n");
+        return;
+    }
+    fprintf(f, "%d\n", N);
+    for (int i = 0; i < N; i++)
+        for (int j = 0; j < N; j++)
+            fprintf(f, "%d %d %d\n", board[i][j], fixed[i][j], solution[i][j]);
+    fclose(f);
+    printf("Gra zapisana!\n");
+}
+
+// Wczytuje grę z pliku
+
+int loadGame() {
+    FILE *f = fopen("save.txt", "r");
+    if (!f) {
+        printf("Brak zapisu gry.\n");
+        return 0;
+    }
+
+    if (fscanf(f, "%d", &N) != 1 || N < 1 || N > MAX_N || (int)sqrt(N) * (int)sqrt(N) != N) {
+        printf("Nieprawidłowy rozmiar planszy w zapisie.\n");
+        fclose(f);
+        return 0;
+    }
+    SRN = sqrt(N);
+    allocBoard();
+
+    for (int i = 0; i < N; i++)
+        for (int j = 0; j < N; j++)
+            fscanf(f, "%d %d %d", &board[i][j], &fixed[i][j], &solution[i][j]);
+
+    fclose(f);
+    printf("Gra wczytana!\n");
+    return 1;
+}
+
+// Czy po wpisaniu wartości plansza nadal ma jakieś rozwiązanie (także inne niż zapisane)
+int moveKeepsSolvable(int row, int col, int val) {
+    cell_t cells[MAX_N * MAX_N];
+    loadCells(board, cells);
+    cells[row * N + col] = val;
+    return countSolutions(N, cells, 1, uniquenessBudget(N)) == 1;
+}
+
+// Główna pętla gry, obsługuje ruchy gracza i interakcję z planszą
+void playGame() {
+    int x, y, val;
+    while (1) {
+        printBoard();
+        printf("Wprowadź ruch: wiersz kolumna wartość (np. 1 2 5), -1 aby zakończyć, -2 aby zapisać, -3 aby usunąć wartość, -4 aby rozwiązać: ");
+        scanf("%d", &x);
+        if (x == -1) break;
+        if (x == -2) {
+            saveGame();
+            continue;
+        }
+        if (x == -3) {
+            printf("Podaj wiersz i kolumnę do wyczyszczenia: ");
+            scanf("%d %d", &x, &y);
+            if (x >= 0 && x < N && y >= 0 && y < N) {
+                if (fixed[x][y]) {
+                    printf("Nie można usunąć stałej wartości.\n");
+                } else {
+                    board[x][y] = 0;
+                }
+            } else {
+                printf("Błędne współrzędne.\n");
+            }
+            continue;
+        }
+
+        if (x == -4) {
+            if (N == 0 || SRN == 0 || board == NULL) {
+                printf("Plansza nie została zainicjalizowana.\n");
+                continue;
+            }
+            printf("Uruchamiam rozwiązywanie przez %s...\n",
+                   useAnnealing ? "symulowane wyżarzanie" : "algorytm genetyczny");
+            solveSudokuGA();
+            continue;
+        }        
+
+        scanf("%d %d", &y, &val);
+        if (x >= 0 && x < N && y >= 0 && y < N && val >= 1 && val <= N) {
+            if (fixed[x][y]) {
+                printf("Nie można zmienić już wypełnionej komórki.\n");
+            } else if (val == solution[x][y] || moveKeepsSolvable(x, y, val)) {
+                board[x][y] = val;
+            } else {
+                printf("Niepoprawny ruch\n");
+            }
+        } else {
+            printf("Błędne dane wejściowe\n");
+        }
+    }
+}
+
+// Docelowa liczba wskazówek dla poziomu trudności
+int cluesForDifficulty(int n, int difficulty) {
+    switch (difficulty) {
+        case 1: return n*n * 0.6;
+        case 2: return n*n * 0.45;
+        case 3: return n*n * 0.3;
+        default: return n*n * 0.5;
+    }
+}
+
+// Na podstawie poziomu trudności generuje planszę sudoku z danym procentem komórek do wypełnienia
+
+void generateSudoku(int difficulty) {
+    allocBoard();
+    fillBoard(board);
+
+    for (int i = 0; i < N; i++)
+        for (int j = 0; j < N; j++)
+            solution[i][j] = board[i][j];
+
+    removeCells(cluesForDifficulty(N, difficulty));
+}
+
+// Mierzy jedno jądro oceny; zwraca liczbę ocen na sekundę
+double timeEvalKernel(const Puzzle *pz, EvalKernel kernel, EvalBatch *batch) {
+    int rounds = 0;
+    double start = nowSeconds(), elapsed;
+    do {
+        kernel(pz, batch);
+        rounds++;
+        elapsed = nowSeconds() - start;
+    } while (elapsed < 0.5);
+    return (double)rounds * batch->count / elapsed;
+}
+
+// Sprawdza zgodność jąder oceny z calculate_conflicts i raportuje oceny na sekundę
+int runEvalBenchmark(int size) {
+    // Pusta łamigłówka - potrzebne są tylko rozmiar i tablice jednostek
+    Puzzle puzzle, *pz = &puzzle;
+    cell_t givens[MAX_N * MAX_N] = { 0 };
+    unsigned char fixedCells[MAX_N * MAX_N] = { 0 };
+    if (size < 1 || size > MAX_N || !puzzleInit(pz, size, givens, fixedCells)) {
+        fprintf(stderr, "Nieobsługiwany rozmiar planszy: %d\n", size);
+        return 1;
+    }
+    int n = pz->n;
+    
+    // Losowe plansze, także z pustymi komórkami, aby sprawdzić dowolne wejście
+    Population pop;
+    EvalBatch batch;
+    allocPopulation(&pop, POPULATION_SIZE, pz);
+    allocEvalBatch(pz, &batch, POPULATION_SIZE);
+    for (int i = 0; i < pop.size; i++)
+        for (int k = 0; k < n * n; k++)
+            pop.members[i].grid[k] = rngInt(&gameRng, n + 1);
+    packPopulation(pz, &pop, &batch);
+    
+    struct { const char *name; EvalKernel kernel; } kernels[3];
+    int kernelCount = 0;
+    kernels[kernelCount].name = "scalar";
+    kernels[kernelCount++].kernel = evalBatchScalar;
+#if defined(__x86_64__) || defined(__i386__)
+    // Jądra wektorowe trzymają maski 16-bitowe - tylko dla n <= 16
+    __builtin_cpu_init();
+    if (n <= 16 && __builtin_cpu_supports("ssse3")) {
+        kernels[kernelCount].name = "ssse3";
+        kernels[kernelCount++].kernel = evalBatchSSSE3;
+    }
+    if (n <= 16 && __builtin_cpu_supports("avx2")) {
+        kernels[kernelCount].name = "avx2";
+        kernels[kernelCount++].kernel = evalBatchAVX2;
+    }
+#endif
+    
+    int mismatches = 0;
+    for (int k = 0; k < kernelCount; k++) {
+        kernels[k].kernel(pz, &batch);
+        for (int i = 0; i < pop.size; i++) {
+            if (batch.fitness[i] != calculate_conflicts(pz, pop.members[i].grid)) mismatches++;
+        }
+    }
+    
+    double start = nowSeconds();
+    int rounds = 0;
+    volatile int sink = 0;
+    do {
+        for (int i = 0; i < pop.size; i++) sink += calculate_conflicts(pz, pop.members[i].grid);
+        rounds++;
+    } while (nowSeconds() - start < 0.5);
+    printf("N=%d reference: %.0f evals/s\n", n, (double)rounds * pop.size / (nowSeconds() - start));
+    for (int k = 0; k < kernelCount; k++) {
+        printf("N=%d %s: %.0f evals/s\n", n, kernels[k].name, timeEvalKernel(pz, kernels[k].kernel, &batch));
+    }
+    const char *defaultName;
+    selectEvalKernel(pz, &defaultName);
+    printf("N=%d default kernel: %s, mismatches: %d\n", n, defaultName, mismatches);
+    
+    freeEvalBatch(&batch);
+    freePopulation(&pop);
+    puzzleFree(pz);
+    return mismatches != 0;
+}
+
+// Łamigłówka testowa n x n: poprawna plansza wzorcowa z losowo usuniętą połową komórek
+int puzzleFromPattern(Puzzle *pz, int n, Rng *rng) {
+    int srn = (int)sqrt(n);
+    cell_t givens[MAX_N * MAX_N];
+    unsigned char fixedCells[MAX_N * MAX_N];
+    for (int r = 0; r < n; r++) {
+        for (int c = 0; c < n; c++) {
+            givens[r * n + c] = (r * srn + r / srn + c) % n + 1;
+            fixedCells[r * n + c] = 1;
+        }
+    }
+    for (int k = 0; k < n * n; k++) {
+        if (rngInt(rng, 2)) {
+            givens[k] = 0;
+            fixedCells[k] = 0;
+        }
+    }
+    return puzzleInit(pz, n, givens, fixedCells);
+}
+
+static int compareDoubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+#define KERNEL_BENCH_ROUNDS 7   // pomiary na wariant; wynik to mediana
+
+// Porównuje jądra specjalizowane z ogólnymi: pokolenia na sekundę dla 4x4 i 16x16.
+// Oba warianty liczą to samo, więc przy tym samym ziarnie muszą dać identyczny wynik.
+int runKernelBenchmark(int generations) {
+    static const int sizes[] = { 4, 16 };
+    int failures = 0;
+    for (int s = 0; s < 2; s++) {
+        Puzzle pz;
+        Rng rng;
+        rngSeed(&rng, gaSeed, sizes[s]);
+        puzzleFromPattern(&pz, sizes[s], &rng);
+        
+        // Warianty mierzone na przemian, żeby zmiany taktowania procesora dotykały obu
+        double rates[2][KERNEL_BENCH_ROUNDS], rate[2];
+        int fitness[2];
+        for (int round = 0; round < KERNEL_BENCH_ROUNDS; round++) {
+            for (int variant = 0; variant < 2; variant++) {
+                pz.kernels = variant == 0 ? &kernelsGeneric : selectSolverKernels(pz.n);
+                SolverParams params = paramsWithSeed(gaSeed);
+                params.threads = 1;
+                GAContext ga;
+                gaInit(&ga, &pz, &params, 0);
+                double start = nowSeconds();
+                for (int g = 0; g < generations; g++) gaGeneration(&ga);
+                rates[variant][round] = generations / (nowSeconds() - start);
+                fitness[variant] = ga.best->fitness;
+                gaFree(&ga);
+            }
+        }
+        for (int variant = 0; variant < 2; variant++) {
+            qsort(rates[variant], KERNEL_BENCH_ROUNDS, sizeof(double), compareDoubles);
+            rate[variant] = rates[variant][KERNEL_BENCH_ROUNDS / 2];
+        }
+        
+        printf("N=%d generic %.1f gen/s, %s %.1f gen/s, speedup %.2fx%s\n", pz.n, rate[0],
+               pz.kernels->name, rate[1], rate[1] / rate[0],
+               fitness[0] == fitness[1] ? "" : " (MISMATCH)");
+        failures += fitness[0] != fitness[1];
+        puzzleFree(&pz);
+    }
+    return failures != 0;
+}
+
+// Podsumowanie serii przebiegów: skuteczność i mediana czasu do rozwiązania
+void summarizeRuns(const char *label, const GAResult *results, int runs) {
+    double *times = malloc(runs * sizeof(double));
+    int solved = 0;
+    long generations = 0;
+    for (int r = 0; r < runs; r++) {
+        if (results[r].fitness == 0) {
+            times[solved++] = results[r].seconds;
+            generations += results[r].generations;
+        }
+    }
+    qsort(times, solved, sizeof(double), compareDoubles);
+    printf("%-12s success %d/%d", label, solved, runs);
+    if (solved > 0) {
+        printf(", median time-to-solution %.3f s, mean generations %.0f",
+               times[solved / 2], (double)generations / solved);
+    }
+    printf("\n");
+    free(times);
+}
+
+// Porównanie modelu wyspowego z jedną populacją na tej samej planszy i tych samych ziarnach
+int runIslandComparison(int runs, int size, int difficulty) {
+    N = size;
+    SRN = sqrt(N);
+    if (SRN * SRN != N || N > MAX_N || runs < 1) {
+        fprintf(stderr, "Nieprawidłowe parametry porównania\n");
+        return 1;
+    }
+    generateSudoku(difficulty);
+    Puzzle pz;
+    puzzleFromBoard(&pz);
+    
+    GAResult *single = malloc(runs * sizeof(GAResult));
+    GAResult *islands = malloc(runs * sizeof(GAResult));
+    for (int r = 0; r < runs; r++) {
+        SolverParams params = paramsWithSeed(gaSeed + r);
+        if (params.islands < 2) params.islands = 4;
+        runSinglePopulation(&pz, &params, &single[r]);
+        runIslandModel(&pz, &params, &islands[r]);
+        printf("run %d: single %d conflicts %.3f s, islands %d conflicts %.3f s\n", r,
+               single[r].fitness, single[r].seconds, islands[r].fitness, islands[r].seconds);
+    }
+    
+    char label[32];
+    snprintf(label, sizeof(label), "islands x%d", gaIslands < 2 ? 4 : gaIslands);
+    summarizeRuns("single", single, runs);
+    summarizeRuns(label, islands, runs);
+    
+    free(single);
+    free(islands);
+    puzzleFree(&pz);
+    freeBoard();
+    return 0;
+}
+
+// Porównanie wyżarzania z algorytmem genetycznym na tej samej planszy i tych samych ziarnach
+int runEngineComparison(int runs, int size, int difficulty) {
+    N = size;
+    SRN = sqrt(N);
+    if (SRN * SRN != N || N > MAX_N || runs < 1) {
+        fprintf(stderr, "Nieprawidłowe parametry porównania\n");
+        return 1;
+    }
+    
+    generateSudoku(difficulty);
+    Puzzle pz;
+    puzzleFromBoard(&pz);
+    
+    GAResult *genetic = malloc(runs * sizeof(GAResult));
+    GAResult *annealing = malloc(runs * sizeof(GAResult));
+    for (int r = 0; r < runs; r++) {
+        SolverParams params = paramsWithSeed(gaSeed + r);
+        runSinglePopulation(&pz, &params, &genetic[r]);
+        runAnnealing(&pz, &params, &annealing[r]);
+        printf("run %d: GA %d conflicts %.3f s, SA %d conflicts %.3f s (%d moves)\n", r,
+               genetic[r].fitness, genetic[r].seconds, annealing[r].fitness, annealing[r].seconds,
+               annealing[r].generations);
+    }
+    
+    summarizeRuns("GA", genetic, runs);
+    summarizeRuns("SA (moves)", annealing, runs);
+    
+    free(genetic);
+    free(annealing);
+    puzzleFree(&pz);
+    freeBoard();
+    return 0;
+}
+
+// Ile komórek usuwa presolve na kolejnych poziomach trudności
+int runPresolveStats(int count, int size) {
+    N = size;
+    SRN = sqrt(N);
+    if (SRN * SRN != N || N > MAX_N || count < 1) {
+        fprintf(stderr, "Nieprawidłowe parametry statystyk presolve\n");
+        return 1;
+    }
+    
+    const char *levels[] = {"", "latwy", "sredni", "trudny"};
+    printf("poziom   plansze  puste   wypelnione  %%      rozwiazane  naked  hidden  locked  czas_us\n");
+    for (int difficulty = 1; difficulty <= 3; difficulty++) {
+        long blanks = 0, filled = 0, naked = 0, hidden = 0, locked = 0;
+        int solved = 0;
+        double seconds = 0;
+        for (int k = 0; k < count; k++) {
+            generateSudoku(difficulty);
+            cell_t cells[MAX_N * MAX_N];
+            unsigned char fixedCells[MAX_N * MAX_N];
+            PresolveStats stats;
+            loadCells(board, cells);
+            for (int i = 0; i < N * N; i++) fixedCells[i] = cells[i] != 0;
+            
+            double start = nowSeconds();
+            solved += presolve(N, cells, fixedCells, &stats);
+            seconds += nowSeconds() - start;
+            blanks += stats.blanks;
+            filled += stats.filled;
+            naked += stats.nakedSingles;
+            hidden += stats.hiddenSingles;
+            locked += stats.lockedEliminations;
+            freeBoard();
+        }
+        printf("%-8s %7d  %6.1f  %10.1f  %5.1f  %5d/%-4d  %5.1f  %6.1f  %6.1f  %7.1f\n",
+               levels[difficulty], count, (double)blanks / count, (double)filled / count,
+               blanks ? 100.0 * filled / blanks : 0.0, solved, count,
+               (double)naked / count, (double)hidden / count, (double)locked / count,
+               seconds * 1e6 / count);
+    }
+    return 0;
+}
+
+// ===== Tryb wsadowy =====
+//
+// Łamigłówki czytane są wierszami z pliku lub stdin: n*n znaków, '.' lub '0' to pusta
+// komórka, '1'-'9' to wartości 1-9, a 'A'... (lub 'a'...) wartości od 10 wzwyż.
+// Pula wątków pobiera kolejne wiersze i dla każdego wypisuje jedną linię:
+//   numer konflikty pokolenia mikrosekundy rozwiązanie
+// Ziarno łamigłówki to --seed + jej numer, więc wynik nie zależy od liczby wątków.
+
+int batchWorkers = 0;           // 0 = liczba procesorów
+
+typedef struct {
+    FILE *in;
+    pthread_mutex_t inputLock, outputLock;
+    long nextIndex;             // numer kolejnej łamigłówki
+    long solved, failed;        // zliczane pod outputLock
+} BatchQueue;
+
+// Wartość komórki z jej znaku; -1 dla znaku niedozwolonego.
+// '1'-'9' to 1-9, 'A'-'Z' (lub 'a'-'z') to 10-35, a '@' to 36 dla planszy 36x36
+int cellFromChar(char ch) {
+    if (ch == '.' || ch == '0') return 0;
+    if (ch >= '1' && ch <= '9') return ch - '0';
+    if (ch >= 'A' && ch <= 'Z') return ch - 'A' + 10;
+    if (ch >= 'a' && ch <= 'z') return ch - 'a' + 10;
+    if (ch == '@') return 36;
+    return -1;
+}
+
+char charFromCell(int val) {
+    if (val == 0) return '.';
+    if (val == 36) return '@';
+    return val <= 9 ? '0' + val : 'A' + val - 10;
+}
+
+// Łamigłówka z wiersza tekstu (po presolve, gdy włączony); zwraca 0 dla błędnego wiersza
+int puzzleFromLine(Puzzle *pz, const char *line, int length, PresolveStats *stats) {
+    int n = (int)sqrt(length);
+    while (n * n < length) n++;
+    if (n * n != length || n > MAX_N) return 0;
+    
+    cell_t givens[MAX_N * MAX_N];
+    unsigned char fixedCells[MAX_N * MAX_N];
+    for (int k = 0; k < length; k++) {
+        int val = cellFromChar(line[k]);
+        if (val < 0 || val > n) return 0;
+        givens[k] = val;
+        fixedCells[k] = val != 0;
+    }
+    memset(stats, 0, sizeof(*stats));
+    if (gaPresolve) {
+        // Przy sprzeczności GA dostaje łamigłówkę bez zmian (jak w solverLoad)
+        cell_t presolved[MAX_N * MAX_N];
+        unsigned char presolvedFixed[MAX_N * MAX_N];
+        memcpy(presolved, givens, length * sizeof(cell_t));
+        memcpy(presolvedFixed, fixedCells, length);
+        presolve(n, presolved, presolvedFixed, stats);
+        if (!stats->contradiction) {
+            memcpy(givens, presolved, length * sizeof(cell_t));
+            memcpy(fixedCells, presolvedFixed, length);
+        }
+    }
+    return puzzleInit(pz, n, givens, fixedCells);
+}
+
+void *batchWorker(void *arg) {
+    BatchQueue *queue = arg;
+    char *line = NULL;
+    size_t capacity = 0;
+    char output[64 + MAX_N * MAX_N];
+    
+    while (1) {
+        // Pobierz kolejny niepusty wiersz (komentarze '#' są pomijane)
+        pthread_mutex_lock(&queue->inputLock);
+        ssize_t length;
+        while ((length = getline(&line, &capacity, queue->in)) >= 0) {
+            while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r' ||
+                                  line[length - 1] == ' ' || line[length - 1] == '\t')) {
+                line[--length] = '\0';
+            }
+            if (length > 0 && line[0] != '#') break;
+        }
+        long index = queue->nextIndex;
+        if (length >= 0) queue->nextIndex++;
+        pthread_mutex_unlock(&queue->inputLock);
+        if (length < 0) break;
+        
+        Puzzle pz;
+        GAResult result;
+        PresolveStats stats;
+        double start = nowSeconds();
+        if (!puzzleFromLine(&pz, line, (int)length, &stats)) {
+            pthread_mutex_lock(&queue->outputLock);
+            printf("%ld error\n", index);
+            queue->failed++;
+            pthread_mutex_unlock(&queue->outputLock);
+            continue;
+        }
+        
+        if (stats.solved) {
+            // Presolve wystarczył - GA nie jest potrzebny
+            result.fitness = 0;
+            result.generations = 0;
+            result.evaluations = 0;
+            result.evaluationsSaved = 0;
+            result.seconds = nowSeconds() - start;
+            memcpy(result.grid, pz.givens, pz.n * pz.n * sizeof(cell_t));
+        } else {
+            SolverParams params = paramsWithSeed(gaSeed + index);
+            solvePuzzle(&pz, &params, &result);
+        }
+        int written = snprintf(output, sizeof(output), "%ld %d %d %.0f ", index,
+                               result.fitness, result.generations, result.seconds * 1e6);
+        for (int k = 0; k < pz.n * pz.n; k++) output[written++] = charFromCell(result.grid[k]);
+        output[written++] = '\n';
+        output[written] = '\0';
+        puzzleFree(&pz);
+        
+        pthread_mutex_lock(&queue->outputLock);
+        fputs(output, stdout);
+        if (result.fitness == 0) queue->solved++;
+        pthread_mutex_unlock(&queue->outputLock);
+    }
+    
+    free(line);
+    return NULL;
+}
+
+// Rozwiązuje wszystkie łamigłówki z pliku (lub stdin dla NULL / "-"); podsumowanie na stderr
+int runBatch(const char *path) {
+    BatchQueue queue;
+    queue.in = (!path || strcmp(path, "-") == 0) ? stdin : fopen(path, "r");
+    if (!queue.in) {
+        fprintf(stderr, "Nie można otworzyć pliku: %s\n", path);
+        return 1;
+    }
+    pthread_mutex_init(&queue.inputLock, NULL);
+    pthread_mutex_init(&queue.outputLock, NULL);
+    queue.nextIndex = 0;
+    queue.solved = 0;
+    queue.failed = 0;
+    
+    int workers = batchWorkers > 0 ? batchWorkers : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (workers < 1) workers = 1;
+    pthread_t *threads = malloc(workers * sizeof(pthread_t));
+    
+    double startTime = nowSeconds();
+    for (int t = 1; t < workers; t++) {
+        pthread_create(&threads[t], NULL, batchWorker, &queue);
+    }
+    batchWorker(&queue);
+    for (int t = 1; t < workers; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    double elapsed = nowSeconds() - startTime;
+    
+    fflush(stdout);
+    fprintf(stderr, "puzzles %ld, solved %ld, errors %ld, workers %d, elapsed %.3f s, %.1f puzzles/s\n",
+            queue.nextIndex, queue.solved, queue.failed, workers, elapsed,
+            elapsed > 0 ? queue.nextIndex / elapsed : 0.0);
+    
+    if (queue.in != stdin) fclose(queue.in);
+    pthread_mutex_destroy(&queue.inputLock);
+    pthread_mutex_destroy(&queue.outputLock);
+    free(threads);
+    return 0;
+}
+
+// ===== Tryb serwera =====
+//
+// --serve [gniazdo|-] to długo działający proces: bez startu programu i przygotowania
+// populacji przy każdej łamigłówce. Protokół to wiersze JSON na gnieździe Unix (każde
+// połączenie osobno) albo na stdin/stdout. Zadanie
+//   {"id":7,"puzzle":"..3.1...","generations":5000,"time_ms":2000,"seed":1}
+// trafia do kolejki i rozwiązuje je jeden z wątków puli (--workers). Każdy wątek ma własny
+// kontekst solvera przygotowany przy starcie i używany ponownie przez solverReset, więc
+// łamigłówki tego rozmiaru co poprzednia nie alokują pamięci. Odpowiedzi przychodzą
+// w kolejności ukończenia i niosą id zadania. {"cmd":"stats"} zwraca liczniki, głębokość
+// kolejki, przepustowość i percentyle opóźnienia (od przyjęcia zadania do odpowiedzi).
+
+#define SERVE_QUEUE_SIZE 1024       // zadania czekające w kolejce; nadmiarowe są odrzucane
+#define SERVE_LATENCY_WINDOW 4096   // liczba ostatnich opóźnień branych do percentyli
+#define SERVE_ID_SIZE 64
+
+// Połączenie klienta; odpowiedzi zapisywane całymi wierszami pod blokadą
+typedef struct {
+    FILE *out;
+    int refs;                   // czytelnik połączenia i zadania w toku
+    pthread_mutex_t lock;
+} ServeConnection;
+
+typedef struct {
+    ServeConnection *connection;
+    char id[SERVE_ID_SIZE];     // id w postaci z żądania (liczba albo napis JSON)
+    int n;
+    cell_t cells[MAX_N * MAX_N];
+    int generations;
+    double timeLimit;           // sekundy; 0 = bez limitu
+    uint64_t seed;
+    double received;
+} ServeJob;
+
+typedef struct {
+    ServeJob *jobs;             // bufor cykliczny SERVE_QUEUE_SIZE zadań
+    int head, count;
+    int inFlight;
+    int stop;
+    int workers;
+    long received, completed, solved, rejected, failed;
+    double *latencies;          // ostatnie SERVE_LATENCY_WINDOW opóźnień [s]
+    double startTime;
+    pthread_mutex_t lock;
+    pthread_cond_t ready, idle;
+} ServeQueue;
+
+// Początek wartości klucza w płaskim obiekcie JSON (bez zagnieżdżeń i sekwencji ucieczki)
+static const char *jsonValue(const char *line, const char *key) {
+    char pattern[32];
+    snprintf(pattern, sizeof(pattern), "\"%s\"", key);
+    const char *p = strstr(line, pattern);
+    if (!p) return NULL;
+    p += strlen(pattern);
+    while (*p == ' ' || *p == '\t') p++;
+    if (*p++ != ':') return NULL;
+    while (*p == ' ' || *p == '\t') p++;
+    return p;
+}
+
+// Napis pod kluczem bez cudzysłowów; zwraca długość albo -1
+static int jsonString(const char *line, const char *key, char *dest, int size) {
+    const char *p = jsonValue(line, key);
+    if (!p || *p != '"') return -1;
+    const char *end = strchr(p + 1, '"');
+    if (!end || end - p - 1 >= size) return -1;
+    memcpy(dest, p + 1, end - p - 1);
+    dest[end - p - 1] = '\0';
+    return (int)(end - p - 1);
+}
+
+static int jsonNumber(const char *line, const char *key, double *value) {
+    const char *p = jsonValue(line, key);
+    if (!p) return 0;
+    char *end;
+    *value = strtod(p, &end);
+    return end != p;
+}
+
+// Liczba z przedziału [min, max]; zwraca 1 gdy jest, 0 gdy brak klucza, -1 gdy wartość
+// jest poza przedziałem (także nieskończoność i NaN) - przed rzutowaniem na int
+static int jsonBounded(const char *line, const char *key, double min, double max, double *value) {
+    if (!jsonNumber(line, key, value)) return 0;
+    return *value >= min && *value <= max ? 1 : -1;
+}
+
+// Liczba całkowita bez znaku - dokładnie, bez zaokrąglenia do double (ziarna powyżej 2^53)
+static int jsonUnsigned(const char *line, const char *key, uint64_t *value) {
+    const char *p = jsonValue(line, key);
+    if (!p || *p < '0' || *p > '9') return 0;
+    char *end;
+    *value = strtoull(p, &end, 10);
+    return end != p;
+}
+
+// Id żądania do odesłania bez zmian: napis razem z cudzysłowami albo liczba; inaczej null
+static void jsonId(const char *line, char *id) {
+    const char *p = jsonValue(line, "id");
+    int length = 0;
+    if (p && *p == '"') {
+        const char *end = strchr(p + 1, '"');
+        if (end && end - p + 1 < SERVE_ID_SIZE) length = (int)(end - p + 1);
+    } else if (p) {
+        while (length < SERVE_ID_SIZE - 1 && (p[length] == '-' || p[length] == '.' ||
+                                              (p[length] >= '0' && p[length] <= '9'))) length++;
+    }
+    if (length == 0) {
+        strcpy(id, "null");
+        return;
+    }
+    memcpy(id, p, length);
+    id[length] = '\0';
+}
+
+static void serveReply(ServeConnection *connection, const char *line) {
+    pthread_mutex_lock(&connection->lock);
+    fputs(line, connection->out);
+    fflush(connection->out);
+    pthread_mutex_unlock(&connection->lock);
+}
+
+// Zwalnia odwołanie do połączenia; ostatnie zamyka strumień odpowiedzi
+static void serveRelease(ServeConnection *connection) {
+    pthread_mutex_lock(&connection->lock);
+    int last = --connection->refs == 0;
+    pthread_mutex_unlock(&connection->lock);
+    if (!last) return;
+    fclose(connection->out);
+    pthread_mutex_destroy(&connection->lock);
+    free(connection);
+}
+
+static void serveError(ServeConnection *connection, const char *id, const char *message) {
+    char reply[SERVE_ID_SIZE + 128];
+    snprintf(reply, sizeof(reply), "{\"id\":%s,\"status\":\"error\",\"error\":\"%s\"}\n", id, message);
+    serveReply(connection, reply);
+}
+
+void serveStats(ServeQueue *queue, ServeConnection *connection, const char *id) {
+    static double latencies[SERVE_LATENCY_WINDOW];
+    static pthread_mutex_t statsLock = PTHREAD_MUTEX_INITIALIZER;
+    pthread_mutex_lock(&statsLock);
+    pthread_mutex_lock(&queue->lock);
+    int count = queue->completed < SERVE_LATENCY_WINDOW ? (int)queue->completed : SERVE_LATENCY_WINDOW;
+    memcpy(latencies, queue->latencies, count * sizeof(double));
+    long received = queue->received, completed = queue->completed, solved = queue->solved;
+    long rejected = queue->rejected, failed = queue->failed;
+    int depth = queue->count, inFlight = queue->inFlight;
+    pthread_mutex_unlock(&queue->lock);
+    
+    qsort(latencies, count, sizeof(double), compareDoubles);
+    double p50 = count ? latencies[(int)ceil(0.50 * count) - 1] : -1;
+    double p99 = count ? latencies[(int)ceil(0.99 * count) - 1] : -1;
+    pthread_mutex_unlock(&statsLock);
+    double uptime = nowSeconds() - queue->startTime;
+    
+    char reply[SERVE_ID_SIZE + 512];
+    snprintf(reply, sizeof(reply),
+             "{\"id\":%s,\"status\":\"stats\",\"received\":%ld,\"completed\":%ld,\"solved\":%ld,"
+             "\"rejected\":%ld,\"failed\":%ld,\"queue_depth\":%d,\"in_flight\":%d,\"workers\":%d,"
+             "\"uptime_s\":%.3f,\"throughput_per_s\":%.3f,\"latency_p50_ms\":%.3f,\"latency_p99_ms\":%.3f}\n",
+             id, received, completed, solved, rejected, failed, depth, inFlight, queue->workers,
+             uptime, uptime > 0 ? completed / uptime : 0.0, p50 >= 0 ? p50 * 1e3 : -1.0, p99 >= 0 ? p99 * 1e3 : -1.0);
+    serveReply(connection, reply);
+}
+
+// Wątek puli: własny kontekst solvera, przygotowany przed pierwszym zadaniem na pustej
+// planszy 9x9 i używany ponownie dla kolejnych zadań
+void *serveWorker(void *arg) {
+    ServeQueue *queue = arg;
+    SolverParams params;
+    solverDefaultParams(&params);
+    params.engine = SOLVER_ENGINE_GA;
+    params.checkpointPath = NULL;
+    cell_t empty[81] = { 0 };
+    SudokuSolver *solver = solverInit(9, empty, &params);
+    char reply[SERVE_ID_SIZE + MAX_N * MAX_N + 256];
+    
+    while (1) {
+        pthread_mutex_lock(&queue->lock);
+        while (queue->count == 0 && !queue->stop) pthread_cond_wait(&queue->ready, &queue->lock);
+        if (queue->count == 0) {
+            pthread_mutex_unlock(&queue->lock);
+            break;
+        }
+        ServeJob job = queue->jobs[queue->head];
+        queue->head = (queue->head + 1) % SERVE_QUEUE_SIZE;
+        queue->count--;
+        queue->inFlight++;
+        pthread_mutex_unlock(&queue->lock);
+        
+        // Budżet pokoleń z żądania, czas sprawdzany po każdym pokoleniu
+        double start = nowSeconds();
+        params.seed = job.seed;
+        params.maxGenerations = job.generations;
+        int solved = 0, valid = solverReset(solver, job.n, job.cells, &params);
+        if (valid) {
+            int status;
+            while ((status = solverStep(solver, 1)) == SOLVER_RUNNING) {
+                if (job.timeLimit > 0 && nowSeconds() - start >= job.timeLimit) break;
+            }
+            cell_t grid[MAX_N * MAX_N];
+            SolverStats stats;
+            solverResult(solver, grid, &stats);
+            solved = status == SOLVER_SOLVED;
+            double finished = nowSeconds();
+            int length = snprintf(reply, sizeof(reply),
+                                  "{\"id\":%s,\"status\":\"%s\",\"conflicts\":%d,\"generations\":%d,"
+                                  "\"queue_ms\":%.3f,\"solve_ms\":%.3f,\"solution\":\"", job.id,
+                                  solved ? "solved" : status == SOLVER_RUNNING ? "timeout" : "exhausted",
+                                  stats.fitness, stats.generations, (start - job.received) * 1e3,
+                                  (finished - start) * 1e3);
+            for (int k = 0; k < job.n * job.n; k++) reply[length++] = charFromCell(grid[k]);
+            snprintf(reply + length, sizeof(reply) - length, "\"}\n");
+        }
+        
+        // Liczniki przed odpowiedzią - klient, który ją dostał, widzi zadanie w statystykach
+        double latency = nowSeconds() - job.received;
+        pthread_mutex_lock(&queue->lock);
+        queue->latencies[queue->completed % SERVE_LATENCY_WINDOW] = latency;
+        queue->completed++;
+        queue->solved += solved;
+        queue->failed += !valid;
+        pthread_mutex_unlock(&queue->lock);
+        
+        if (valid) serveReply(job.connection, reply);
+        else serveError(job.connection, job.id, "invalid puzzle");
+        serveRelease(job.connection);
+        
+        pthread_mutex_lock(&queue->lock);
+        queue->inFlight--;
+        if (queue->count == 0 && queue->inFlight == 0) pthread_cond_broadcast(&queue->idle);
+        pthread_mutex_unlock(&queue->lock);
+    }
+    solverDestroy(solver);
+    return NULL;
+}
+
+// Czyta żądania jednego połączenia aż do końca strumienia
+void serveSession(ServeQueue *queue, FILE *in, ServeConnection *connection) {
+    char *line = NULL;
+    size_t capacity = 0;
+    ssize_t length;
+    while ((length = getline(&line, &capacity, in)) >= 0) {
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) line[--length] = '\0';
+        if (length == 0) continue;
+        
+        char id[SERVE_ID_SIZE];
+        char command[16];
+        jsonId(line, id);
+        if (jsonString(line, "cmd", command, sizeof(command)) >= 0) {
+            if (strcmp(command, "stats") == 0) serveStats(queue, connection, id);
+            else serveError(connection, id, "unknown command");
+            continue;
+        }
+        
+        ServeJob job;
+        char puzzle[MAX_N * MAX_N + 1];
+        int cells = jsonString(line, "puzzle", puzzle, sizeof(puzzle));
+        job.n = (int)sqrt(cells > 0 ? cells : 0);
+        int valid = cells > 0 && job.n * job.n == cells;
+        for (int k = 0; valid && k < cells; k++) {
+            int val = cellFromChar(puzzle[k]);
+            valid = val >= 0 && val <= job.n;
+            job.cells[k] = val;
+        }
+        
+        // Budżety: pokolenia od 1, czas od 0 (bez limitu); oba najwyżej INT32_MAX
+        double generations = 0, timeMs = 0;
+        int hasGenerations = jsonBounded(line, "generations", 1, INT32_MAX, &generations);
+        int hasTime = jsonBounded(line, "time_ms", 0, INT32_MAX, &timeMs);
+        const char *error = !valid ? "invalid puzzle" : hasGenerations < 0 || hasTime < 0 ? "invalid budget" : NULL;
+        if (error) {
+            pthread_mutex_lock(&queue->lock);
+            queue->failed++;
+            pthread_mutex_unlock(&queue->lock);
+            serveError(connection, id, error);
+            continue;
+        }
+        job.connection = connection;
+        strcpy(job.id, id);
+        job.generations = hasGenerations ? (int)generations : gaGenerations;
+        job.timeLimit = hasTime ? timeMs / 1e3 : 0;
+        job.received = nowSeconds();
+        
+        pthread_mutex_lock(&queue->lock);
+        int accepted = queue->count < SERVE_QUEUE_SIZE;
+        if (accepted) {
+            if (!jsonUnsigned(line, "seed", &job.seed)) job.seed = gaSeed + queue->received;
+            pthread_mutex_lock(&connection->lock);
+            connection->refs++;
+            pthread_mutex_unlock(&connection->lock);
+            queue->jobs[(queue->head + queue->count) % SERVE_QUEUE_SIZE] = job;
+            queue->count++;
+            queue->received++;
+            pthread_cond_signal(&queue->ready);
+        } else {
+            queue->rejected++;
         }
-        printf("\n");
+        pthread_mutex_unlock(&queue->lock);
+        if (!accepted) serveError(connection, id, "queue full");
     }
+    free(line);
 }
 
-// Zapisuje stan gry do pliku
+typedef struct {
+    ServeQueue *queue;
+    FILE *in;
+    ServeConnection *connection;
+} ServeClient;
 
-void saveGame() {
-    FILE *f = fopen("save.txt", "w");
-    if (!f) {
-        printf("Błąd zapisu\n");
-        return;
-    }
-    fprintf(f, "%d\n", N);
-    for (int i = 0; i < N; i++)
-        for (int j = 0; j < N; j++)
-            fprintf(f, "%d %d %d\n", board[i][j], fixed[i][j], solution[i][j]);
-    fclose(f);
-    printf("Gra zapisana!\n");
+void *serveClient(void *arg) {
+    ServeClient *client = arg;
+    serveSession(client->queue, client->in, client->connection);
+    fclose(client->in);
+    serveRelease(client->connection);
+    free(client);
+    return NULL;
 }
 
-// Wczytuje grę z pliku
+static ServeConnection *serveConnection(FILE *out) {
+    ServeConnection *connection = malloc(sizeof(ServeConnection));
+    connection->out = out;
+    connection->refs = 1;
+    pthread_mutex_init(&connection->lock, NULL);
+    return connection;
+}
 
-int loadGame() {
-    FILE *f = fopen("save.txt", "r");
-    if (!f) {
-        printf("Brak zapisu gry.\n");
-        return 0;
+// Uruchamia serwer na gnieździe Unix path albo na stdin/stdout (path == NULL lub "-").
+// Tryb stdin kończy się po końcu wejścia i obsłużeniu wszystkich zadań; gniazdo działa do przerwania
+int runServe(const char *path) {
+    ServeQueue queue;
+    memset(&queue, 0, sizeof(queue));
+    queue.jobs = malloc(SERVE_QUEUE_SIZE * sizeof(ServeJob));
+    queue.latencies = malloc(SERVE_LATENCY_WINDOW * sizeof(double));
+    queue.workers = batchWorkers > 0 ? batchWorkers : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    queue.startTime = nowSeconds();
+    pthread_mutex_init(&queue.lock, NULL);
+    pthread_cond_init(&queue.ready, NULL);
+    pthread_cond_init(&queue.idle, NULL);
+    
+    int listener = -1;
+    if (path && strcmp(path, "-") != 0) {
+        struct sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (strlen(path) >= sizeof(address.sun_path)) {
+            fprintf(stderr, "Za długa ścieżka gniazda: %s\n", path);
+            return 1;
+        }
+        strcpy(address.sun_path, path);
+        listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        unlink(path);
+        if (listener < 0 || bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+            listen(listener, 16) != 0) {
+            fprintf(stderr, "Nie można nasłuchiwać na gnieździe: %s\n", path);
+            return 1;
+        }
+        signal(SIGPIPE, SIG_IGN);   // klient mógł się rozłączyć przed odpowiedzią
+    }
+    
+    pthread_t *threads = malloc(queue.workers * sizeof(pthread_t));
+    for (int t = 0; t < queue.workers; t++) {
+        pthread_create(&threads[t], NULL, serveWorker, &queue);
+    }
+    fprintf(stderr, "Serwer: %s, wątki: %d\n", listener >= 0 ? path : "stdin/stdout", queue.workers);
+    
+    if (listener >= 0) {
+        while (1) {
+            int fd = accept(listener, NULL, NULL);
+            if (fd < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            ServeClient *client = malloc(sizeof(ServeClient));
+            client->queue = &queue;
+            client->in = fdopen(fd, "r");
+            client->connection = serveConnection(fdopen(dup(fd), "w"));
+            pthread_t thread;
+            pthread_create(&thread, NULL, serveClient, client);
+            pthread_detach(thread);
+        }
+        close(listener);
+    } else {
+        // Odwołanie wątku głównego nie jest zwalniane - stdout zostaje otwarty
+        ServeConnection *connection = serveConnection(stdout);
+        serveSession(&queue, stdin, connection);
+        pthread_mutex_lock(&queue.lock);
+        while (queue.count > 0 || queue.inFlight > 0) pthread_cond_wait(&queue.idle, &queue.lock);
+        pthread_mutex_unlock(&queue.lock);
+        pthread_mutex_destroy(&connection->lock);
+        free(connection);
     }
+    
+    pthread_mutex_lock(&queue.lock);
+    queue.stop = 1;
+    pthread_cond_broadcast(&queue.ready);
+    pthread_mutex_unlock(&queue.lock);
+    for (int t = 0; t < queue.workers; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    double elapsed = nowSeconds() - queue.startTime;
+    fprintf(stderr, "zadania %ld, rozwiązane %ld, błędne %ld, odrzucone %ld, %.3f s, %.1f zadań/s\n",
+            queue.completed, queue.solved, queue.failed, queue.rejected, elapsed,
+            elapsed > 0 ? queue.completed / elapsed : 0.0);
+    
+    free(threads);
+    free(queue.jobs);
+    free(queue.latencies);
+    pthread_mutex_destroy(&queue.lock);
+    pthread_cond_destroy(&queue.ready);
+    pthread_cond_destroy(&queue.idle);
+    return 0;
+}
 
-    fscanf(f, "%d", &N);
-    SRN = sqrt(N);
-    allocBoard();
+// Wznawia przebieg GA z punktu kontrolnego; kolejne punkty trafiają domyślnie do tego samego pliku
+int runResume(const char *path) {
+    SolverParams params;
+    solverDefaultParams(&params);
+    params.engine = SOLVER_ENGINE_GA;
+    params.checkpointPath = gaCheckpointPath ? gaCheckpointPath : path;
+    params.verbose = 1;
+    
+    SudokuSolver *s = calloc(1, sizeof(SudokuSolver));
+    if (!s || !path || !checkpointLoad(path, &params, &s->puzzle, &s->ga)) {
+        fprintf(stderr, "Nieprawidłowy punkt kontrolny: %s\n", path ? path : "(brak pliku)");
+        free(s);
+        return 1;
+    }
+    s->ownsPuzzle = 1;
+    s->pz = &s->puzzle;
+    s->params = s->ga.params;
+    s->gaAllocated = 1;
+    s->gaActive = 1;
+    printf("Wznowiono przebieg %dx%d od pokolenia %d (najlepszy fitness = %d, wątki: %d)\n",
+           s->puzzle.n, s->puzzle.n, s->ga.generation, s->ga.best->fitness, s->ga.workerCount);
+    solverAttach(s);
+    if (gaProgressInterval > 0) solverSetProgress(s, printProgress, NULL, gaProgressInterval);
+    solverRun(s);
+    
+    GAResult result;
+    solverCollect(s, &result);
+    char line[MAX_N * MAX_N + 1];
+    for (int k = 0; k < s->puzzle.n * s->puzzle.n; k++) line[k] = charFromCell(result.grid[k]);
+    line[s->puzzle.n * s->puzzle.n] = '\0';
+    printf("\nKonflikty: %d, pokolenia: %d\n%s\n", result.fitness, result.generations, line);
+    solverDestroy(s);
+    return result.fitness == 0 ? 0 : 2;
+}
 
-    for (int i = 0; i < N; i++)
-        for (int j = 0; j < N; j++)
-            fscanf(f, "%d %d %d", &board[i][j], &fixed[i][j], &solution[i][j]);
+// ===== Benchmark na stałym korpusie =====
+//
+// Każda łamigłówka korpusu (pliki w formacie trybu wsadowego, poziom trudności z
+// komentarza "# NxN, poziom D") rozwiązywana jest benchRuns razy każdym silnikiem,
+// ze stałymi ziarnami. Wyniki zbierane są w grupach silnik/rozmiar/poziom i wypisywane
+// jako wiersze JSON albo CSV, dzięki czemu można je porównywać między wersjami.
 
-    fclose(f);
-    printf("Gra wczytana!\n");
-    return 1;
+const char *benchCorpus[] = {"corpus/4x4.txt", "corpus/9x9.txt", "corpus/16x16.txt"};
+int benchRuns = 3;              // przebiegi na łamigłówkę
+int benchCsv = 0;               // 0 = wiersze JSON, 1 = CSV
+char benchEngines[32] = "ga,sa";
+
+typedef struct {
+    const char *engine;
+    int size, difficulty;
+    GAResult *results;
+    int count, capacity;
+    int presolved;              // przebiegi zakończone już przez presolve
+} BenchGroup;
+
+// Szczytowe zużycie pamięci procesu w KiB
+long peakRssKb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
 }
 
-// Główna pętla gry, obsługuje ruchy gracza i interakcję z planszą
-void playGame() {
-    int x, y, val;
-    while (1) {
-        printBoard();
-        printf("Wprowadź ruch: wiersz kolumna wartość (np. 1 2 5), -1 aby zakończyć, -2 aby zapisać, -3 aby usunąć wartość, -4 aby rozwiązać: ");
-        scanf("%d", &x);
-        if (x == -1) break;
-        if (x == -2) {
-            saveGame();
-            continue;
+void benchReport(const BenchGroup *group, int header) {
+    if (group->count == 0) return;
+    double *times = malloc(group->count * sizeof(double));
+    int solved = 0;
+    long generations = 0, evaluations = 0, saved = 0;
+    double seconds = 0;
+    for (int r = 0; r < group->count; r++) {
+        const GAResult *result = &group->results[r];
+        if (result->fitness == 0) {
+            times[solved++] = result->seconds;
+            generations += result->generations;
         }
-        if (x == -3) {
-            printf("Podaj wiersz i kolumnę do wyczyszczenia: ");
-            scanf("%d %d", &x, &y);
-            if (x >= 0 && x < N && y >= 0 && y < N) {
-                if (fixed[x][y]) {
-                    printf("Nie można usunąć stałej wartości.\n");
-                } else {
-                    board[x][y] = 0;
+        evaluations += result->evaluations;
+        saved += result->evaluationsSaved;
+        seconds += result->seconds;
+    }
+    qsort(times, solved, sizeof(double), compareDoubles);
+    double median = solved ? times[solved / 2] : -1;
+    double p95 = solved ? times[(int)ceil(0.95 * solved) - 1] : -1;
+    double meanGenerations = solved ? (double)generations / solved : -1;
+    double evalsPerSecond = seconds > 0 ? evaluations / seconds : 0;
+    double savedRate = evaluations > 0 ? (double)saved / evaluations : 0;
+    
+    if (benchCsv) {
+        if (header) printf("engine,size,difficulty,runs,success_rate,presolved_rate,median_s,p95_s,mean_generations,evals_per_s,saved_eval_rate,peak_rss_kb\n");
+        printf("%s,%d,%d,%d,%.3f,%.3f,%.6f,%.6f,%.1f,%.0f,%.3f,%ld\n", group->engine, group->size,
+               group->difficulty, group->count, (double)solved / group->count,
+               (double)group->presolved / group->count, median, p95, meanGenerations,
+               evalsPerSecond, savedRate, peakRssKb());
+    } else {
+        printf("{\"engine\":\"%s\",\"size\":%d,\"difficulty\":%d,\"runs\":%d,\"success_rate\":%.3f,"
+               "\"presolved_rate\":%.3f,\"median_s\":%.6f,\"p95_s\":%.6f,\"mean_generations\":%.1f,"
+               "\"evals_per_s\":%.0f,\"saved_eval_rate\":%.3f,\"peak_rss_kb\":%ld}\n", group->engine,
+               group->size, group->difficulty, group->count, (double)solved / group->count,
+               (double)group->presolved / group->count, median, p95, meanGenerations,
+               evalsPerSecond, savedRate, peakRssKb());
+    }
+    fflush(stdout);
+    free(times);
+}
+
+// Uruchamia benchmark na podanych plikach (domyślnie benchCorpus); -1 w wynikach = brak rozwiązań
+int runBenchmark(int fileCount, char **files) {
+    if (fileCount == 0) {
+        fileCount = sizeof(benchCorpus) / sizeof(benchCorpus[0]);
+        files = (char **)benchCorpus;
+    }
+    int savedAnnealing = useAnnealing;
+    int header = 1;
+    uint64_t seed = gaSeedSet ? gaSeed : 1;
+    
+    char engines[32];
+    snprintf(engines, sizeof(engines), "%s", benchEngines);
+    for (char *engine = strtok(engines, ","); engine; engine = strtok(NULL, ",")) {
+        if (strcmp(engine, "ga") != 0 && strcmp(engine, "ma") != 0 && strcmp(engine, "sa") != 0) {
+            fprintf(stderr, "Nieznany silnik: %s\n", engine);
+            return 1;
+        }
+        useAnnealing = strcmp(engine, "sa") == 0;
+        
+        for (int f = 0; f < fileCount; f++) {
+            FILE *in = fopen(files[f], "r");
+            if (!in) {
+                fprintf(stderr, "Nie można otworzyć pliku: %s\n", files[f]);
+                return 1;
+            }
+            BenchGroup group = {engine, 0, 0, NULL, 0, 0, 0};
+            char *line = NULL;
+            size_t capacity = 0;
+            ssize_t length;
+            int index = 0, difficulty = 0;
+            while ((length = getline(&line, &capacity, in)) >= 0) {
+                while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) line[--length] = '\0';
+                if (length == 0) continue;
+                if (line[0] == '#') {
+                    char *level = strstr(line, "poziom");
+                    if (level) sscanf(level, "poziom %d", &difficulty);
+                    continue;
                 }
-            } else {
-                printf("Błędne współrzędne.\n");
+                
+                // Czas presolve wliczany jest do każdego przebiegu
+                Puzzle pz;
+                PresolveStats stats;
+                double presolveStart = nowSeconds();
+                int valid = puzzleFromLine(&pz, line, (int)length, &stats);
+                double presolveSeconds = nowSeconds() - presolveStart;
+                if (!valid) {
+                    fprintf(stderr, "%s: błędny wiersz %d\n", files[f], index);
+                    continue;
+                }
+                if (pz.n != group.size || difficulty != group.difficulty) {
+                    benchReport(&group, header);
+                    header &= group.count == 0;
+                    group.size = pz.n;
+                    group.difficulty = difficulty;
+                    group.count = 0;
+                    group.presolved = 0;
+                }
+                
+                for (int r = 0; r < benchRuns; r++) {
+                    if (group.count == group.capacity) {
+                        group.capacity = group.capacity ? 2 * group.capacity : 16;
+                        group.results = realloc(group.results, group.capacity * sizeof(GAResult));
+                    }
+                    GAResult *result = &group.results[group.count++];
+                    if (stats.solved) {
+                        result->fitness = 0;
+                        result->generations = 0;
+                        result->evaluations = 0;
+                        result->evaluationsSaved = 0;
+                        result->seconds = 0;
+                        group.presolved++;
+                    } else {
+                        // "ga" to czysty algorytm genetyczny, "ma" - z krokiem memetycznym
+                        SolverParams params = paramsWithSeed(seed + (uint64_t)index * benchRuns + r);
+                        params.localSearch = 0;
+                        if (strcmp(engine, "ma") == 0) {
+                            params.localSearch = gaLocalSearch > 0 ? gaLocalSearch : LOCAL_SEARCH_BUDGET;
+                        }
+                        solvePuzzle(&pz, &params, result);
+                    }
+                    result->seconds += presolveSeconds;
+                    fprintf(stderr, "%s %s #%d run %d: %d conflicts, %.3f s\n", engine, files[f],
+                            index, r, result->fitness, result->seconds);
+                }
+                puzzleFree(&pz);
+                index++;
             }
-            continue;
+            benchReport(&group, header);
+            header &= group.count == 0;
+            free(group.results);
+            free(line);
+            fclose(in);
         }
+    }
+    
+    useAnnealing = savedAnnealing;
+    return 0;
+}
 
-        if (x == -4) {
-            if (N == 0 || SRN == 0 || board == NULL) {
-                printf("Plansza nie została zainicjalizowana.\n");
-                continue;
-            }
-            printf("Uruchamiam rozwiązywanie przez algorytm genetyczny...\n");
-            solveSudokuGA();
-            continue;
-        }        
+// ===== Przeszukiwanie parametrów GA =====
+//
+// --sweep [konfiguracje] [plik...] porównuje zestawy parametrów GA na korpusie (domyślnie
+// benchCorpus). Zestawy pochodzą z siatki wartości poniżej: 0 konfiguracji oznacza całą
+// siatkę, inna liczba - tyle różnych zestawów wylosowanych z siatki. Każda łamigłówka
+// rozwiązywana jest benchRuns razy każdym zestawem, z tymi samymi ziarnami dla wszystkich
+// zestawów. Zadania (zestaw, łamigłówka, przebieg) rozdziela pula batchWorkers wątków,
+// a każde rozwiązywanie jest jednowątkowe. Pozostałe parametry (limit pokoleń, presolve,
+// operatory, krok memetyczny) pochodzą z linii poleceń i są wspólne dla wszystkich zestawów.
+//
+// Wynik to ranking zestawów w każdej grupie rozmiar/poziom (odsetek sukcesów malejąco,
+// potem mediana czasu rozwiązania rosnąco) jako wiersze JSON lub CSV. Najlepszy zestaw
+// ogółem (średni odsetek sukcesów w grupach, potem łączny czas wszystkich przebiegów)
+// zapisywany jest do sweepOutput w formacie pliku --config.
 
-        scanf("%d %d", &y, &val);
-        if (x >= 0 && x < N && y >= 0 && y < N && val >= 1 && val <= N) {
-            if (fixed[x][y]) {
-                printf("Nie można zmienić już wypełnionej komórki.\n");
-            } else if (val == solution[x][y]) {
-                board[x][y] = val;
-            } else {
-                printf("Niepoprawny ruch\n");
-            }
+const char *sweepOutput = "sweep.conf";    // plik z najlepszą konfiguracją (--sweep-out)
+
+static const int sweepPopulations[] = { 200, 500, 1000 };
+static const double sweepMutationRates[] = { 0.05, 0.15, 0.3 };
+static const double sweepCrossoverRates[] = { 0.6, 0.8, 0.95 };
+static const double sweepElitismRates[] = { 0.05, 0.2 };
+static const int sweepTournamentSizes[] = { 2, 3, 5 };
+static const int sweepSelections[][2] = { { 0, 0 }, { 0, 1 }, { 1, 1 } };   // indeksy selectionStrategies
+static const int sweepCrossovers[] = { SOLVER_CROSSOVER_MIXED, SOLVER_CROSSOVER_POINT, SOLVER_CROSSOVER_BLOCK };
+
+#define SWEEP_DIMENSION(values) ((int)(sizeof(values) / sizeof(values[0])))
+
+typedef struct {
+    Puzzle pz;
+    int group;                  // indeks grupy rozmiar/poziom
+    int presolved;              // rozwiązana już przez presolve
+    double presolveSeconds;
+} SweepPuzzle;
+
+typedef struct {
+    int fitness;
+    double seconds;
+} SweepRun;
+
+typedef struct {
+    const SolverParams *configs;
+    const SweepPuzzle *puzzles;
+    int puzzleCount;
+    SweepRun *runs;             // [zestaw][łamigłówka][przebieg]
+    long taskCount, nextTask, done;
+    uint64_t seed;
+    pthread_mutex_t lock;
+} SweepQueue;
+
+typedef struct {
+    int config;
+    double successRate;
+    double median;              // -1 = brak rozwiązań
+} SweepScore;
+
+// Zestaw parametrów o danym numerze w siatce (kolejne wymiary jak cyfry liczby)
+void sweepConfig(long index, SolverParams *params) {
+    params->populationSize = sweepPopulations[index % SWEEP_DIMENSION(sweepPopulations)];
+    index /= SWEEP_DIMENSION(sweepPopulations);
+    params->mutationRate = sweepMutationRates[index % SWEEP_DIMENSION(sweepMutationRates)];
+    index /= SWEEP_DIMENSION(sweepMutationRates);
+    params->crossoverRate = sweepCrossoverRates[index % SWEEP_DIMENSION(sweepCrossoverRates)];
+    index /= SWEEP_DIMENSION(sweepCrossoverRates);
+    params->elitismRate = sweepElitismRates[index % SWEEP_DIMENSION(sweepElitismRates)];
+    index /= SWEEP_DIMENSION(sweepElitismRates);
+    params->tournamentSize = sweepTournamentSizes[index % SWEEP_DIMENSION(sweepTournamentSizes)];
+    index /= SWEEP_DIMENSION(sweepTournamentSizes);
+    const int *selection = sweepSelections[index % SWEEP_DIMENSION(sweepSelections)];
+    params->selection[0] = selectionStrategies[selection[0]].name;
+    params->selection[1] = selectionStrategies[selection[1]].name;
+    index /= SWEEP_DIMENSION(sweepSelections);
+    params->crossover = sweepCrossovers[index % SWEEP_DIMENSION(sweepCrossovers)];
+}
+
+long sweepGridSize() {
+    return (long)SWEEP_DIMENSION(sweepPopulations) * SWEEP_DIMENSION(sweepMutationRates) *
+           SWEEP_DIMENSION(sweepCrossoverRates) * SWEEP_DIMENSION(sweepElitismRates) *
+           SWEEP_DIMENSION(sweepTournamentSizes) * SWEEP_DIMENSION(sweepSelections) *
+           SWEEP_DIMENSION(sweepCrossovers);
+}
+
+void *sweepWorker(void *arg) {
+    SweepQueue *queue = arg;
+    int runsPerConfig = queue->puzzleCount * benchRuns;
+    GAResult result;
+    
+    while (1) {
+        pthread_mutex_lock(&queue->lock);
+        long task = queue->nextTask < queue->taskCount ? queue->nextTask++ : -1;
+        pthread_mutex_unlock(&queue->lock);
+        if (task < 0) break;
+        
+        // Ziarno zależy tylko od łamigłówki i przebiegu - zestawy grają tymi samymi kośćmi
+        int config = task / runsPerConfig;
+        int index = task % runsPerConfig / benchRuns;
+        int r = task % benchRuns;
+        const SweepPuzzle *puzzle = &queue->puzzles[index];
+        SweepRun *run = &queue->runs[task];
+        if (puzzle->presolved) {
+            run->fitness = 0;
+            run->seconds = 0;
         } else {
-            printf("Błędne dane wejściowe\n");
+            SolverParams params = queue->configs[config];
+            params.seed = queue->seed + (uint64_t)index * benchRuns + r;
+            runSinglePopulation(&puzzle->pz, &params, &result);
+            run->fitness = result.fitness;
+            run->seconds = result.seconds;
+        }
+        run->seconds += puzzle->presolveSeconds;
+        
+        pthread_mutex_lock(&queue->lock);
+        long done = ++queue->done;
+        pthread_mutex_unlock(&queue->lock);
+        if (done % (queue->taskCount / 20 + 1) == 0 || done == queue->taskCount) {
+            fprintf(stderr, "sweep: %ld/%ld runs\n", done, queue->taskCount);
         }
     }
+    return NULL;
 }
 
-// Na podstawie poziomu trudności generuje planszę sudoku z danym procentem komórek do wypełnienia
+static int compareSweepScores(const void *a, const void *b) {
+    const SweepScore *x = a, *y = b;
+    if (x->successRate != y->successRate) return x->successRate > y->successRate ? -1 : 1;
+    double mx = x->median < 0 ? INFINITY : x->median, my = y->median < 0 ? INFINITY : y->median;
+    if (mx != my) return mx < my ? -1 : 1;
+    return x->config - y->config;
+}
 
-void generateSudoku(int difficulty) {
-    allocBoard();
-    fillBoard(0, 0, board);
+// Parametry GA zestawu w formacie pliku --config
+void writeConfig(FILE *out, const SolverParams *params) {
+    fprintf(out, "population = %d\n", params->populationSize);
+    fprintf(out, "generations = %d\n", params->maxGenerations);
+    fprintf(out, "mutation = %g\n", params->mutationRate);
+    fprintf(out, "crossover-rate = %g\n", params->crossoverRate);
+    fprintf(out, "elitism = %g\n", params->elitismRate);
+    fprintf(out, "tournament = %d\n", params->tournamentSize);
+    fprintf(out, "selection = %s,%s\n", params->selection[0], params->selection[1]);
+    fprintf(out, "crossover = %s\n", crossoverNames[params->crossover]);
+}
 
-    for (int i = 0; i < N; i++)
-        for (int j = 0; j < N; j++)
-            solution[i][j] = board[i][j];
+void sweepReport(const SolverParams *params, int size, int difficulty, int rank, int runs,
+                 const SweepScore *score, int header) {
+    if (benchCsv) {
+        if (header) printf("size,difficulty,rank,population,mutation,crossover_rate,elitism,tournament,selection,crossover,runs,success_rate,median_s\n");
+        printf("%d,%d,%d,%d,%g,%g,%g,%d,%s+%s,%s,%d,%.3f,%.6f\n", size, difficulty, rank,
+               params->populationSize, params->mutationRate, params->crossoverRate, params->elitismRate,
+               params->tournamentSize, params->selection[0], params->selection[1],
+               crossoverNames[params->crossover], runs, score->successRate, score->median);
+    } else {
+        printf("{\"size\":%d,\"difficulty\":%d,\"rank\":%d,\"population\":%d,\"mutation\":%g,"
+               "\"crossover_rate\":%g,\"elitism\":%g,\"tournament\":%d,\"selection\":\"%s,%s\","
+               "\"crossover\":\"%s\",\"runs\":%d,\"success_rate\":%.3f,\"median_s\":%.6f}\n", size,
+               difficulty, rank, params->populationSize, params->mutationRate, params->crossoverRate,
+               params->elitismRate, params->tournamentSize, params->selection[0], params->selection[1],
+               crossoverNames[params->crossover], runs, score->successRate, score->median);
+    }
+}
 
-    int clues;
-    switch (difficulty) {
-        case 1: clues = N*N * 0.6; break;
-        case 2: clues = N*N * 0.45; break;
-        case 3: clues = N*N * 0.3; break;
-        default: clues = N*N * 0.5; break;
-    }
-    removeCells(clues);
-}
-
-// Inicjalizuje puste komórki w blokach 3x3 tak, aby były unikalne
-void initialize_solution_randomly() {
-    for (int block_row = 0; block_row < SRN; block_row++) {
-        for (int block_col = 0; block_col < SRN; block_col++) {
-            int present[N + 1];
-            for (int i = 0; i <= N; i++) present[i] = 0;
-            int positions[N];
-            int idx = 0;
-
-            for (int i = 0; i < SRN; i++) {
-                for (int j = 0; j < SRN; j++) {
-                    int r = block_row * SRN + i;
-                    int c = block_col * SRN + j;
-                    if (board[r][c] != 0)
-                        present[board[r][c]] = 1;
-                    else
-                        positions[idx++] = r * N + c;
-                }
+int runSweep(int configCount, int fileCount, char **files) {
+    if (fileCount == 0) {
+        fileCount = sizeof(benchCorpus) / sizeof(benchCorpus[0]);
+        files = (char **)benchCorpus;
+    }
+    
+    // Cały korpus w pamięci; grupy rozmiar/poziom w kolejności wystąpienia
+    SweepPuzzle *puzzles = NULL;
+    int puzzleCount = 0, puzzleCapacity = 0;
+    int groupSize[64], groupDifficulty[64], groupCount = 0;
+    for (int f = 0; f < fileCount; f++) {
+        FILE *in = fopen(files[f], "r");
+        if (!in) {
+            fprintf(stderr, "Nie można otworzyć pliku: %s\n", files[f]);
+            return 1;
+        }
+        char *line = NULL;
+        size_t capacity = 0;
+        ssize_t length;
+        int difficulty = 0;
+        while ((length = getline(&line, &capacity, in)) >= 0) {
+            while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) line[--length] = '\0';
+            if (length == 0) continue;
+            if (line[0] == '#') {
+                char *level = strstr(line, "poziom");
+                if (level) sscanf(level, "poziom %d", &difficulty);
+                continue;
             }
-
-            int values[N];
-            int val_idx = 0;
-            for (int v = 1; v <= N; v++)
-                if (!present[v])
-                    values[val_idx++] = v;
-
-            for (int i = val_idx - 1; i > 0; i--) {
-                int j = rand() % (i + 1);
-                int tmp = values[i];
-                values[i] = values[j];
-                values[j] = tmp;
+            if (puzzleCount == puzzleCapacity) {
+                puzzleCapacity = puzzleCapacity ? 2 * puzzleCapacity : 64;
+                puzzles = realloc(puzzles, puzzleCapacity * sizeof(SweepPuzzle));
             }
-
-            for (int i = 0; i < val_idx; i++) {
-                int r = positions[i] / N;
-                int c = positions[i] % N;
-                board[r][c] = values[i];
+            SweepPuzzle *puzzle = &puzzles[puzzleCount];
+            PresolveStats stats;
+            double presolveStart = nowSeconds();
+            if (!puzzleFromLine(&puzzle->pz, line, (int)length, &stats)) {
+                fprintf(stderr, "%s: błędny wiersz\n", files[f]);
+                continue;
+            }
+            puzzle->presolveSeconds = nowSeconds() - presolveStart;
+            puzzle->presolved = stats.solved;
+            int g = 0;
+            while (g < groupCount && (groupSize[g] != puzzle->pz.n || groupDifficulty[g] != difficulty)) g++;
+            if (g == groupCount) {
+                if (groupCount == 64) {
+                    fprintf(stderr, "Za dużo grup rozmiar/poziom w korpusie\n");
+                    return 1;
+                }
+                groupSize[g] = puzzle->pz.n;
+                groupDifficulty[g] = difficulty;
+                groupCount++;
+            }
+            puzzle->group = g;
+            puzzleCount++;
+        }
+        free(line);
+        fclose(in);
+    }
+    if (puzzleCount == 0) {
+        fprintf(stderr, "Pusty korpus\n");
+        return 1;
+    }
+    
+    // Zestawy: cała siatka albo configCount różnych, wylosowanych z siatki
+    long gridSize = sweepGridSize();
+    if (configCount <= 0 || configCount > gridSize) configCount = gridSize;
+    long *order = malloc(gridSize * sizeof(long));
+    for (long k = 0; k < gridSize; k++) order[k] = k;
+    Rng sweepRng;
+    rngSeed(&sweepRng, gaSeedSet ? gaSeed : 1, UINT32_MAX - 1);
+    if (configCount < gridSize) {
+        for (int k = 0; k < configCount; k++) {
+            long other = k + rngInt(&sweepRng, gridSize - k);
+            long swap = order[k];
+            order[k] = order[other];
+            order[other] = swap;
+        }
+    }
+    SolverParams *configs = malloc(configCount * sizeof(SolverParams));
+    for (int c = 0; c < configCount; c++) {
+        configs[c] = paramsWithSeed(0);
+        configs[c].engine = SOLVER_ENGINE_GA;
+        configs[c].threads = 1;
+        configs[c].checkpointPath = NULL;
+        configs[c].verbose = 0;
+        sweepConfig(order[c], &configs[c]);
+    }
+    free(order);
+    
+    SweepQueue queue;
+    queue.configs = configs;
+    queue.puzzles = puzzles;
+    queue.puzzleCount = puzzleCount;
+    queue.taskCount = (long)configCount * puzzleCount * benchRuns;
+    queue.runs = malloc(queue.taskCount * sizeof(SweepRun));
+    queue.nextTask = 0;
+    queue.done = 0;
+    queue.seed = gaSeedSet ? gaSeed : 1;
+    pthread_mutex_init(&queue.lock, NULL);
+    
+    int workers = batchWorkers > 0 ? batchWorkers : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (workers < 1) workers = 1;
+    fprintf(stderr, "sweep: %d configurations, %d puzzles, %d runs each, %d workers\n",
+            configCount, puzzleCount, benchRuns, workers);
+    pthread_t *threads = malloc(workers * sizeof(pthread_t));
+    double startTime = nowSeconds();
+    for (int t = 1; t < workers; t++) {
+        pthread_create(&threads[t], NULL, sweepWorker, &queue);
+    }
+    sweepWorker(&queue);
+    for (int t = 1; t < workers; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    double elapsed = nowSeconds() - startTime;
+    
+    // Ranking w każdej grupie oraz wynik ogólny zestawów
+    SweepScore *scores = malloc(configCount * sizeof(SweepScore));
+    double *successSum = calloc(configCount, sizeof(double));
+    double *totalSeconds = calloc(configCount, sizeof(double));
+    double *times = malloc((long)puzzleCount * benchRuns * sizeof(double));
+    int header = 1;
+    for (int g = 0; g < groupCount; g++) {
+        int runs = 0;
+        for (int c = 0; c < configCount; c++) {
+            int solved = 0;
+            runs = 0;
+            for (int p = 0; p < puzzleCount; p++) {
+                if (puzzles[p].group != g) continue;
+                const SweepRun *run = &queue.runs[((long)c * puzzleCount + p) * benchRuns];
+                for (int r = 0; r < benchRuns; r++) {
+                    if (run[r].fitness == 0) times[solved++] = run[r].seconds;
+                    totalSeconds[c] += run[r].seconds;
+                    runs++;
+                }
             }
+            qsort(times, solved, sizeof(double), compareDoubles);
+            scores[c].config = c;
+            scores[c].successRate = (double)solved / runs;
+            scores[c].median = solved ? times[solved / 2] : -1;
+            successSum[c] += scores[c].successRate;
+        }
+        qsort(scores, configCount, sizeof(SweepScore), compareSweepScores);
+        for (int k = 0; k < configCount; k++) {
+            sweepReport(&configs[scores[k].config], groupSize[g], groupDifficulty[g], k + 1, runs, &scores[k], header);
+            header = 0;
         }
     }
+    fflush(stdout);
+    
+    int best = 0;
+    for (int c = 1; c < configCount; c++) {
+        if (successSum[c] > successSum[best] ||
+            (successSum[c] == successSum[best] && totalSeconds[c] < totalSeconds[best])) best = c;
+    }
+    fprintf(stderr, "sweep: %ld runs in %.3f s; best: mean success %.3f, total %.3f s\n",
+            queue.taskCount, elapsed, successSum[best] / groupCount, totalSeconds[best]);
+    int status = 0;
+    FILE *out = fopen(sweepOutput, "w");
+    if (out) {
+        fprintf(out, "# Najlepsza konfiguracja z --sweep: %d zestawów, %d łamigłówek po %d przebiegi\n",
+                configCount, puzzleCount, benchRuns);
+        fprintf(out, "# średni odsetek sukcesów %.3f, łączny czas %.3f s\n",
+                successSum[best] / groupCount, totalSeconds[best]);
+        writeConfig(out, &configs[best]);
+        fclose(out);
+        fprintf(stderr, "sweep: best configuration written to %s\n", sweepOutput);
+    } else {
+        fprintf(stderr, "Nie można zapisać pliku: %s\n", sweepOutput);
+        status = 1;
+    }
+    
+    for (int p = 0; p < puzzleCount; p++) puzzleFree(&puzzles[p].pz);
+    pthread_mutex_destroy(&queue.lock);
+    free(puzzles);
+    free(configs);
+    free(queue.runs);
+    free(threads);
+    free(scores);
+    free(successSum);
+    free(totalSeconds);
+    free(times);
+    return status;
 }
 
-// Losowa zamiana dwóch niezamrożonych komórek w tym samym bloku
-void generate_neighbor() {
-    int block_row = rand() % SRN;
-    int block_col = rand() % SRN;
-    int r1, c1, r2, c2;
+// ===== Masowe generowanie łamigłówek =====
+//
+// Pula wątków generuje count łamigłówek o jednoznacznym rozwiązaniu na każdy poziom
+// trudności i zapisuje je w formacie trybu wsadowego (z komentarzami '#' przed każdym
+// poziomem). Łamigłówka k używa strumienia k ziarna --seed, więc plik nie zależy od
+// liczby wątków.
 
-    int attempts = 0;
-    do {
-        r1 = block_row * SRN + rand() % SRN;
-        c1 = block_col * SRN + rand() % SRN;
-        r2 = block_row * SRN + rand() % SRN;
-        c2 = block_col * SRN + rand() % SRN;
-        attempts++;
-    } while ((fixed[r1][c1] || fixed[r2][c2] || (r1 == r2 && c1 == c2)) && attempts < 100);
+typedef struct {
+    int n, count, total;
+    char *lines;                // total wierszy po n*n znaków
+    int *clues;                 // liczba wskazówek każdej łamigłówki
+    pthread_mutex_t lock;
+    int next;
+} GenerateQueue;
+
+void *generateWorker(void *arg) {
+    GenerateQueue *queue = arg;
+    int n = queue->n;
+    while (1) {
+        pthread_mutex_lock(&queue->lock);
+        int index = queue->next++;
+        pthread_mutex_unlock(&queue->lock);
+        if (index >= queue->total) break;
+        
+        Rng rng;
+        rngSeed(&rng, gaSeed, index);
+        cell_t cells[MAX_N * MAX_N];
+        memset(cells, 0, sizeof(cells));
+        fillGrid(n, cells, &rng);
+        queue->clues[index] = carvePuzzle(n, cells, cluesForDifficulty(n, index / queue->count + 1), &rng);
+        
+        char *line = queue->lines + (long)index * n * n;
+        for (int k = 0; k < n * n; k++) line[k] = charFromCell(cells[k]);
+    }
+    return NULL;
+}
 
-    if (!fixed[r1][c1] && !fixed[r2][c2]) {
-        int tmp = board[r1][c1];
-        board[r1][c1] = board[r2][c2];
-        board[r2][c2] = tmp;
+// Zapisuje count łamigłówek na poziom do pliku (stdout dla NULL / "-"); podsumowanie na stderr
+int runGenerate(int count, int size, const char *path) {
+    int srn = (int)sqrt(size);
+    if (srn * srn != size || size > MAX_N || count < 1) {
+        fprintf(stderr, "Nieprawidłowe parametry generowania\n");
+        return 1;
+    }
+    FILE *out = (!path || strcmp(path, "-") == 0) ? stdout : fopen(path, "w");
+    if (!out) {
+        fprintf(stderr, "Nie można otworzyć pliku: %s\n", path);
+        return 1;
+    }
+    
+    GenerateQueue queue;
+    queue.n = size;
+    queue.count = count;
+    queue.total = 3 * count;
+    queue.lines = malloc((long)queue.total * size * size);
+    queue.clues = malloc(queue.total * sizeof(int));
+    queue.next = 0;
+    pthread_mutex_init(&queue.lock, NULL);
+    
+    int workers = batchWorkers > 0 ? batchWorkers : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (workers < 1) workers = 1;
+    pthread_t *threads = malloc(workers * sizeof(pthread_t));
+    
+    double startTime = nowSeconds();
+    for (int t = 1; t < workers; t++) {
+        pthread_create(&threads[t], NULL, generateWorker, &queue);
+    }
+    generateWorker(&queue);
+    for (int t = 1; t < workers; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    double elapsed = nowSeconds() - startTime;
+    
+    for (int difficulty = 1; difficulty <= 3; difficulty++) {
+        long clues = 0;
+        fprintf(out, "# %dx%d, poziom %d\n", size, size, difficulty);
+        for (int k = (difficulty - 1) * count; k < difficulty * count; k++) {
+            fwrite(queue.lines + (long)k * size * size, 1, size * size, out);
+            fputc('\n', out);
+            clues += queue.clues[k];
+        }
+        fprintf(stderr, "poziom %d: cel %d wskazówek, średnio %.1f\n", difficulty,
+                cluesForDifficulty(size, difficulty), (double)clues / count);
     }
+    fprintf(stderr, "puzzles %d, workers %d, elapsed %.3f s, %.1f puzzles/s\n",
+            queue.total, workers, elapsed, elapsed > 0 ? queue.total / elapsed : 0.0);
+    
+    if (out != stdout) fclose(out);
+    pthread_mutex_destroy(&queue.lock);
+    free(queue.lines);
+    free(queue.clues);
+    free(threads);
+    return 0;
 }
 
 // Wyświetla menu i obsługuje wybór użytkownika.
@@ -691,12 +4910,11 @@ void menu() {
         scanf("%d", &choice);
         switch (choice) {
             case 1: {
-                printf("Rozmiar planszy (1 - 4x4, 2 - 9x9, 3 - 16x16): ");
+                printf("Rozmiar planszy (1 - 4x4, 2 - 9x9, 3 - 16x16, 4 - 25x25, 5 - 36x36): ");
                 int sizeOpt; scanf("%d", &sizeOpt);
-                if (sizeOpt == 1) N = 4;
-                else if (sizeOpt == 2) N = 9;
-                else N = 16;
-                SRN = sqrt(N);
+                if (sizeOpt < 1 || sizeOpt > 5) sizeOpt = 3;
+                SRN = sizeOpt + 1;
+                N = SRN * SRN;
 
                 printf("Poziom trudności (1 - łatwy, 2 - średni, 3 - trudny): ");
                 int diff; scanf("%d", &diff);
@@ -722,10 +4940,285 @@ void menu() {
     } while (choice != 3);
 }
 
-// Funkcja główna. obsługuje menu i tworzy losową planszę sudoku na podstawie aktualnego czasu systemowego.
+// Argument pozycyjny trybu (liczba) lub wartość domyślna, gdy go brak
+int positionalArg(int argc, char **argv, int index, int fallback) {
+    if (index >= argc || strncmp(argv[index], "--", 2) == 0) return fallback;
+    return atoi(argv[index]);
+}
+
+// Flagi trybów uruchomienia (obsługiwane w main, nie przez parseOption)
+static const char *const modeFlags[] = {
+    "--bench-eval", "--bench-kernels", "--serve", "--resume", "--batch", "--compare-islands",
+    "--compare-engines", "--bench", "--sweep", "--generate", "--presolve-stats"
+};
+
+static int isModeFlag(const char *arg) {
+    for (size_t k = 0; k < sizeof(modeFlags) / sizeof(modeFlags[0]); k++)
+        if (strcmp(arg, modeFlags[k]) == 0) return 1;
+    return 0;
+}
+
+int loadConfig(const char *path);
+
+// Ustawia opcję name na value; zwraca 1 gdy opcja jest znana, 0 gdy nie, -1 przy błędzie.
+// Opcje wspólne: --threads N, --seed S, --selection A[,B],
+// --islands K, --island-size S, --migration M, --topology ring|random, --workers W,
+// --presolve on|off, --engine ga|sa, --sa-temp T, --sa-cooling A, --sa-chain L,
+// --sa-reheat R, --sa-steps S, --bench-runs R, --bench-engines ga,sa, --bench-format json|csv,
+// --trace plik, --progress K, --stagnation K, --dedup on|off, --operators blocks|mixed,
+// --checkpoint plik, --checkpoint-every K, --local-search K, --local-search-top P,
+// --population P, --generations G, --mutation M, --crossover-rate C, --elitism E,
+// --tournament T, --crossover mixed|point|block, --sweep-out plik, --config plik.
+int parseOption(const char *name, const char *value) {
+    if (strcmp(name, "--threads") == 0) {
+        gaThreads = atoi(value);
+    } else if (strcmp(name, "--seed") == 0) {
+        gaSeed = strtoull(value, NULL, 10);
+        gaSeedSet = 1;
+    } else if (strcmp(name, "--selection") == 0) {
+        // --selection PIERWSZY[,DRUGI] - strategie wyboru rodziców
+        char names[64];
+        snprintf(names, sizeof(names), "%s", value);
+        char *second = strchr(names, ',');
+        if (second) *second++ = '\0';
+        const SelectionStrategy *first = findSelectionStrategy(names);
+        const SelectionStrategy *other = second ? findSelectionStrategy(second) : first;
+        if (!first || !other) {
+            fprintf(stderr, "Nieznana strategia selekcji: %s\n", value);
+            return -1;
+        }
+        parentSelection[0] = first;
+        parentSelection[1] = other;
+    } else if (strcmp(name, "--islands") == 0) {
+        gaIslands = atoi(value);
+    } else if (strcmp(name, "--island-size") == 0) {
+        gaIslandSize = atoi(value);
+    } else if (strcmp(name, "--migration") == 0) {
+        gaMigrationInterval = atoi(value);
+        if (gaMigrationInterval < 1) gaMigrationInterval = 1;
+    } else if (strcmp(name, "--topology") == 0) {
+        gaRandomTopology = strcmp(value, "random") == 0;
+    } else if (strcmp(name, "--workers") == 0) {
+        batchWorkers = atoi(value);
+    } else if (strcmp(name, "--presolve") == 0) {
+        gaPresolve = strcmp(value, "off") != 0;
+    } else if (strcmp(name, "--engine") == 0) {
+        useAnnealing = strcmp(value, "sa") == 0;
+    } else if (strcmp(name, "--sa-temp") == 0) {
+        saInitialTemp = atof(value);
+    } else if (strcmp(name, "--sa-cooling") == 0) {
+        saCooling = atof(value);
+        if (saCooling <= 0 || saCooling >= 1) saCooling = 0.99;
+    } else if (strcmp(name, "--sa-chain") == 0) {
+        saChainLength = atoi(value);
+    } else if (strcmp(name, "--sa-reheat") == 0) {
+        saReheatAfter = atoi(value);
+        if (saReheatAfter < 1) saReheatAfter = 1;
+    } else if (strcmp(name, "--sa-steps") == 0) {
+        saMaxSteps = atol(value);
+    } else if (strcmp(name, "--bench-runs") == 0) {
+        benchRuns = atoi(value);
+        if (benchRuns < 1) benchRuns = 1;
+    } else if (strcmp(name, "--bench-engines") == 0) {
+        snprintf(benchEngines, sizeof(benchEngines), "%s", value);
+    } else if (strcmp(name, "--bench-format") == 0) {
+        benchCsv = strcmp(value, "csv") == 0;
+    } else if (strcmp(name, "--trace") == 0) {
+        gaTraceFile = fopen(value, "w");
+        if (!gaTraceFile) {
+            fprintf(stderr, "Nie można otworzyć pliku: %s\n", value);
+            return -1;
+        }
+    } else if (strcmp(name, "--progress") == 0) {
+        gaProgressInterval = atoi(value);
+    } else if (strcmp(name, "--stagnation") == 0) {
+        gaStagnationLimit = atoi(value);
+    } else if (strcmp(name, "--dedup") == 0) {
+        gaDedup = strcmp(value, "off") != 0;
+    } else if (strcmp(name, "--operators") == 0) {
+        gaBlockOperators = strcmp(value, "mixed") != 0;
+    } else if (strcmp(name, "--local-search") == 0) {
+        gaLocalSearch = atoi(value);
+    } else if (strcmp(name, "--local-search-top") == 0) {
+        gaLocalSearchShare = atof(value) / 100.0;
+        if (gaLocalSearchShare <= 0 || gaLocalSearchShare > 1) gaLocalSearchShare = 1;
+    } else if (strcmp(name, "--checkpoint") == 0) {
+        gaCheckpointPath = value;
+    } else if (strcmp(name, "--checkpoint-every") == 0) {
+        gaCheckpointInterval = atoi(value);
+    } else if (strcmp(name, "--population") == 0) {
+        gaPopulationSize = atoi(value);
+        if (gaPopulationSize < 2) gaPopulationSize = 2;
+    } else if (strcmp(name, "--generations") == 0) {
+        gaGenerations = atoi(value);
+        if (gaGenerations < 1) gaGenerations = 1;
+    } else if (strcmp(name, "--mutation") == 0) {
+        gaMutationRate = atof(value);
+        if (gaMutationRate < 0 || gaMutationRate >= 1) gaMutationRate = MUTATION_RATE;
+    } else if (strcmp(name, "--crossover-rate") == 0) {
+        gaCrossoverRate = atof(value);
+        if (gaCrossoverRate < 0 || gaCrossoverRate > 1) gaCrossoverRate = CROSSOVER_RATE;
+    } else if (strcmp(name, "--elitism") == 0) {
+        gaElitismRate = atof(value);
+        if (gaElitismRate < 0 || gaElitismRate >= 1) gaElitismRate = ELITISM_RATE;
+    } else if (strcmp(name, "--tournament") == 0) {
+        gaTournamentSize = atoi(value);
+        if (gaTournamentSize < 1) gaTournamentSize = 1;
+    } else if (strcmp(name, "--crossover") == 0) {
+        int k = SOLVER_CROSSOVER_BLOCK;
+        while (k >= 0 && strcmp(value, crossoverNames[k]) != 0) k--;
+        if (k < 0) {
+            fprintf(stderr, "Nieznany operator krzyżowania: %s\n", value);
+            return -1;
+        }
+        gaCrossover = k;
+    } else if (strcmp(name, "--sweep-out") == 0) {
+        sweepOutput = value;
+    } else if (strcmp(name, "--config") == 0) {
+        if (!loadConfig(value)) return -1;
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+// Plik konfiguracji (--config, zapisywany też przez --sweep): wiersze "klucz = wartość",
+// gdzie klucz to nazwa opcji bez "--"; '#' rozpoczyna komentarz. Opcje z linii poleceń
+// podane po --config nadpisują wartości z pliku. Zwraca 0 przy błędzie.
+int loadConfig(const char *path) {
+    FILE *in = fopen(path, "r");
+    if (!in) {
+        fprintf(stderr, "Nie można otworzyć pliku: %s\n", path);
+        return 0;
+    }
+    char line[512];
+    int lineNumber = 0, valid = 1;
+    while (valid && fgets(line, sizeof(line), in)) {
+        lineNumber++;
+        char *comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+        if (strspn(line, " \t\r\n") == strlen(line)) continue;
+        
+        char key[64], value[448], option[80];
+        if (sscanf(line, " %63[^= \t] = %447[^\r\n]", key, value) != 2) {
+            fprintf(stderr, "%s:%d: oczekiwano \"klucz = wartość\"\n", path, lineNumber);
+            valid = 0;
+            break;
+        }
+        int length = strlen(value);
+        while (length > 0 && (value[length - 1] == ' ' || value[length - 1] == '\t')) value[--length] = '\0';
+        
+        // Wartość zostaje w pamięci do końca programu - opcje mogą zapamiętać wskaźnik
+        snprintf(option, sizeof(option), "--%s", key);
+        int known = parseOption(option, strdup(value));
+        if (known == 0) fprintf(stderr, "%s:%d: nieznany klucz: %s\n", path, lineNumber, key);
+        valid = known > 0;
+    }
+    fclose(in);
+    return valid;
+}
 
-int main() {
-    srand(time(NULL));
+// Funkcja główna. obsługuje menu i tworzy losową planszę sudoku na podstawie aktualnego czasu systemowego.
+// Przy budowie biblioteki (-DSUDOKU_NO_MAIN) pomijana - zostaje samo API z sudoku_solver.h.
+#ifndef SUDOKU_NO_MAIN
+int main(int argc, char **argv) {
+    // Tryb może stać w dowolnym miejscu wśród opcji; jego argumenty pozycyjne idą zaraz za nim
+    int mode = 0;
+    for (int i = 1; i < argc; i++) {
+        if (isModeFlag(argv[i])) {
+            if (mode) {
+                fprintf(stderr, "Podano dwa tryby: %s i %s\n", argv[mode], argv[i]);
+                return 1;
+            }
+            mode = i;
+            continue;
+        }
+        if (i + 1 >= argc) break;
+        int known = parseOption(argv[i], argv[i + 1]);
+        if (known < 0) return 1;
+        i += known;
+    }
+    // Widok argumentów z trybem na pozycji 1, jak przy ./sudoku --tryb ...
+    if (mode) {
+        argv += mode - 1;
+        argc -= mode - 1;
+    }
+    
+    // Bez jawnego ziarna każde uruchomienie jest inne
+    if (!gaSeedSet) gaSeed = (uint64_t)time(NULL);
+    rngSeed(&gameRng, gaSeed, UINT32_MAX);
+    
+    // Tryb pomiaru silnika oceny: --bench-eval [rozmiar]
+    if (argc > 1 && strcmp(argv[1], "--bench-eval") == 0) {
+        return runEvalBenchmark(positionalArg(argc, argv, 2, 9));
+    }
+    
+    // Porównanie jąder specjalizowanych z ogólnymi: --bench-kernels [pokolenia]
+    if (argc > 1 && strcmp(argv[1], "--bench-kernels") == 0) {
+        return runKernelBenchmark(positionalArg(argc, argv, 2, 200));
+    }
+    
+    // Serwer rozwiązujący: --serve [gniazdo|-]
+    if (argc > 1 && strcmp(argv[1], "--serve") == 0) {
+        return runServe(argc > 2 && strncmp(argv[2], "--", 2) != 0 ? argv[2] : NULL);
+    }
+    
+    // Wznowienie przebiegu GA: --resume plik
+    if (argc > 1 && strcmp(argv[1], "--resume") == 0) {
+        return runResume(argc > 2 && strncmp(argv[2], "--", 2) != 0 ? argv[2] : NULL);
+    }
+    
+    // Tryb wsadowy bez interakcji: --batch [plik|-]
+    if (argc > 1 && strcmp(argv[1], "--batch") == 0) {
+        return runBatch(argc > 2 && strncmp(argv[2], "--", 2) != 0 ? argv[2] : NULL);
+    }
+    
+    // Porównanie modelu wyspowego z jedną populacją: --compare-islands [przebiegi] [rozmiar] [trudność]
+    if (argc > 1 && strcmp(argv[1], "--compare-islands") == 0) {
+        return runIslandComparison(positionalArg(argc, argv, 2, 10),
+                                   positionalArg(argc, argv, 3, 9),
+                                   positionalArg(argc, argv, 4, 3));
+    }
+    
+    // Porównanie wyżarzania z GA: --compare-engines [przebiegi] [rozmiar] [trudność]
+    if (argc > 1 && strcmp(argv[1], "--compare-engines") == 0) {
+        return runEngineComparison(positionalArg(argc, argv, 2, 10),
+                                   positionalArg(argc, argv, 3, 9),
+                                   positionalArg(argc, argv, 4, 2));
+    }
+    
+    // Benchmark na korpusie: --bench [plik...] (domyślnie corpus/*.txt)
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        int fileCount = 0;
+        while (2 + fileCount < argc && strncmp(argv[2 + fileCount], "--", 2) != 0) fileCount++;
+        return runBenchmark(fileCount, argv + 2);
+    }
+    
+    // Przeszukiwanie parametrów GA: --sweep [konfiguracje] [plik...] (0 konfiguracji = cała siatka)
+    if (argc > 1 && strcmp(argv[1], "--sweep") == 0) {
+        int first = 2, configCount = 20;
+        if (first < argc && argv[first][0] && strspn(argv[first], "0123456789") == strlen(argv[first])) {
+            configCount = atoi(argv[first++]);
+        }
+        int fileCount = 0;
+        while (first + fileCount < argc && strncmp(argv[first + fileCount], "--", 2) != 0) fileCount++;
+        return runSweep(configCount, fileCount, argv + first);
+    }
+    
+    // Masowe generowanie łamigłówek: --generate [liczba] [rozmiar] [plik|-]
+    if (argc > 1 && strcmp(argv[1], "--generate") == 0) {
+        return runGenerate(positionalArg(argc, argv, 2, 100),
+                           positionalArg(argc, argv, 3, 9),
+                           argc > 4 && strncmp(argv[4], "--", 2) != 0 ? argv[4] : NULL);
+    }
+    
+    // Statystyki propagacji ograniczeń: --presolve-stats [plansze] [rozmiar]
+    if (argc > 1 && strcmp(argv[1], "--presolve-stats") == 0) {
+        return runPresolveStats(positionalArg(argc, argv, 2, 200),
+                                positionalArg(argc, argv, 3, 9));
+    }
+    
     menu();
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -0,0 +1,126 @@
+// Biblioteka solvera Sudoku (algorytm genetyczny) - publiczne API.
+//
+// Każde rozwiązywanie ma własny, nieprzezroczysty kontekst z łamigłówką, parametrami
+// i populacją, więc wiele rozwiązywań może działać równocześnie w różnych wątkach.
+// Jednego kontekstu nie wolno używać z kilku wątków naraz.
+//
+// Użycie jako biblioteki: gcc -O2 -pthread -DSUDOKU_NO_MAIN -c sudoku15.c
+// i dołączenie sudoku15.o do programu (z -pthread -lm).
+
+#ifndef SUDOKU_SOLVER_H
+#define SUDOKU_SOLVER_H
+
+#include <stdint.h>
+
+typedef struct SudokuSolver SudokuSolver;
+
+// Silnik rozwiązywania. Tylko SOLVER_ENGINE_GA działa krokowo; wyspy i wyżarzanie
+// wykonują się w całości przy pierwszym wywołaniu solverStep (ustawienia w polach
+// islands... i annealing... parametrów).
+enum {
+    SOLVER_ENGINE_GA,
+    SOLVER_ENGINE_ISLANDS,
+    SOLVER_ENGINE_ANNEALING
+};
+
+// Stan rozwiązywania zwracany przez solverStep i solverRun
+enum {
+    SOLVER_RUNNING,     // można wykonywać kolejne kroki
+    SOLVER_SOLVED,      // znaleziono rozwiązanie bez konfliktów
+    SOLVER_EXHAUSTED,   // osiągnięto limit pokoleń
+    SOLVER_STOPPED      // przerwane przez funkcję postępu
+};
+
+// Operator krzyżowania: losowo jeden z dwóch (jak dotąd), cięcie wierszami
+// (przy operatorach blokowych - pasmami bloków) albo wymiana całych bloków
+enum {
+    SOLVER_CROSSOVER_MIXED,
+    SOLVER_CROSSOVER_POINT,
+    SOLVER_CROSSOVER_BLOCK
+};
+
+typedef struct {
+    uint64_t seed;
+    int engine;                 // SOLVER_ENGINE_*
+    int populationSize;
+    int maxGenerations;
+    int threads;                // wątki produkujące potomstwo w jednym rozwiązywaniu
+    double mutationRate;        // bazowe prawdopodobieństwo mutacji komórki
+    double crossoverRate;       // prawdopodobieństwo krzyżowania pary rodziców
+    double elitismRate;         // ułamek populacji przechodzący bez zmian do następnego pokolenia
+    int tournamentSize;         // uczestnicy turnieju przy selekcji turniejowej
+    int crossover;              // SOLVER_CROSSOVER_*
+    const char *selection[2];   // strategie wyboru rodziców: "tournament" lub "roulette"
+    int presolve;               // propagacja ograniczeń przed GA
+    int blockOperators;         // operatory zachowujące permutacje w blokach
+    int dedup;                  // pomijanie ocen duplikatów i mutowanie klonów
+    int stagnationLimit;        // pokolenia bez poprawy przed reakcją; 0 = wyłączone
+    int localSearch;            // krok memetyczny: budżet kroków min-conflicts na dziecko; 0 = wyłączone
+    double localSearchShare;    // przeszukiwane dzieci nie gorsze od tego ułamka najlepszych rodziców
+    int islands;                // SOLVER_ENGINE_ISLANDS: liczba wysp, każda w osobnym wątku
+    int islandSize;             // rozmiar wyspy; 0 = populationSize / islands
+    int migrationInterval;      // co ile pokoleń wyspy wymieniają najlepsze osobniki
+    int randomTopology;         // 0 = pierścień, 1 = losowa wyspa docelowa
+    double annealingTemp;       // SOLVER_ENGINE_ANNEALING: temperatura początkowa; 0 = z próby ruchów
+    double annealingCooling;    // mnożnik temperatury po każdym łańcuchu ruchów
+    int annealingChain;         // ruchy na jednej temperaturze; 0 = z liczby wolnych komórek bloków
+    int annealingReheat;        // łańcuchy bez poprawy przed ponownym podgrzaniem
+    long annealingSteps;        // limit ruchów
+    const char *checkpointPath; // plik punktów kontrolnych; NULL = bez zapisu
+    int checkpointInterval;     // co ile pokoleń zapisywać punkt kontrolny
+    int verbose;                // komunikaty na stdout (start, wynik, czasy faz)
+} SolverParams;
+
+// Migawka postępu przekazywana do funkcji zwrotnej
+typedef struct {
+    int generation;             // numer ostatniego pokolenia (od 0)
+    int bestFitness;            // konflikty najlepszego osobnika bieżącej populacji
+    int recordFitness;          // najmniej konfliktów w całym przebiegu
+    int restarts;               // restarty populacji po stagnacji
+    double mutationRate;        // bieżące prawdopodobieństwo mutacji
+    double seconds;             // czas od solverInit
+} SolverProgress;
+
+// Wywoływana co interval pokoleń; wartość różna od 0 przerywa rozwiązywanie
+typedef int (*SolverProgressCallback)(const SolverProgress *progress, void *userData);
+
+typedef struct {
+    int fitness;                // konflikty najlepszego rozwiązania (0 = rozwiązane)
+    int generations;            // wykonane pokolenia (wyżarzanie: ruchy)
+    long evaluations;           // oceny rozwiązań
+    long evaluationsSaved;      // oceny pominięte dzięki skrótom genomów
+    long localSearchMoves;      // zamiany wykonane przez lokalne przeszukiwanie
+    int presolvedCells;         // komórki wypełnione przez propagację ograniczeń
+    int restarts;
+    double seconds;
+} SolverStats;
+
+// Parametry domyślne (w programie sudoku15 - z linii poleceń)
+void solverDefaultParams(SolverParams *params);
+
+// Tworzy kontekst dla planszy n x n (n = k*k, n <= 36); cells to n*n wartości wierszami,
+// 0 = puste pole. params == NULL oznacza parametry domyślne. NULL przy błędnych danych.
+SudokuSolver *solverInit(int n, const unsigned char *cells, const SolverParams *params);
+
+// Rozpoczyna w istniejącym kontekście nową łamigłówkę (jak solverInit; funkcja postępu
+// zostaje). Przy tym samym rozmiarze planszy, populacji, elity i liczbie wątków areny i wątki
+// są używane ponownie bez alokacji. Zwraca 0 przy błędnych danych (kontekst bez zmian).
+int solverReset(SudokuSolver *solver, int n, const unsigned char *cells, const SolverParams *params);
+
+// Funkcja postępu wywoływana co interval pokoleń (NULL wyłącza)
+void solverSetProgress(SudokuSolver *solver, SolverProgressCallback callback, void *userData, int interval);
+
+// Wykonuje co najwyżej generations pokoleń; zwraca stan SOLVER_*
+int solverStep(SudokuSolver *solver, int generations);
+
+// Rozwiązuje do skutku (rozwiązanie, limit pokoleń albo przerwanie); zwraca stan SOLVER_*
+int solverRun(SudokuSolver *solver);
+
+// Najlepsza dotąd plansza (n*n wartości, może być NULL) i statystyki (może być NULL);
+// zwraca liczbę konfliktów
+int solverResult(const SudokuSolver *solver, unsigned char *grid, SolverStats *stats);
+
+// Zwalnia kontekst (zatrzymuje wątki i zapis punktów kontrolnych)
+void solverDestroy(SudokuSolver *solver);
+
+#endif